@@ -12,7 +12,9 @@ namespace rs_error
         EventFd_read_fail, // 事件监控文件描述符读取失败
         EventFd_write_fail, // 事件监控文件描述符写入失败
         Timerfd_create_fail, // 定时器文件描述符创建失败
-        Timerfd_read_fail // 定时器文件描述符读取失败
+        Timerfd_read_fail, // 定时器文件描述符读取失败
+        IoUring_submit_fail, // io_uring提交失败
+        IoUring_wait_fail // io_uring等待失败
     };
 }
 
@@ -1,12 +1,20 @@
 #ifndef __rs_acceptor_h__
 #define __rs_acceptor_h__
 
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
 #include <reactor_server/net/socket.h>
 #include <reactor_server/net/event_loop_lock_queue.h>
 #include <reactor_server/net/channel.h>
 
 namespace rs_acceptor
 {
+    using namespace rs_log_system;
+
+    // 单次可读事件最多获取的连接数，防止连接风暴时长时间占用事件循环
+    const int default_accept_budget = 64;
+
     /**
      * 当前类不处理Connection的创建，当前类只是接收连接，获取到对应的连接描述符
      * 具体如何处理连接描述符交给上层（服务器模块）处理
@@ -17,31 +25,142 @@ namespace rs_acceptor
         using ptr = std::shared_ptr<Acceptor>;
         // 连接文件描述符处理回调
         using acceptCallback_t = std::function<void(int)>;
+        // 批量连接文件描述符处理回调
+        using acceptBatchCallback_t = std::function<void(const std::vector<int> &)>;
 
         Acceptor(rs_event_loop_lock_queue::EventLoopLockQueue* loop, int port)
-            : loop_(loop), channel_(std::make_shared<rs_channel::Channel>(loop_, getAcceptFd(port)))
+            : loop_(loop), channel_(std::make_shared<rs_channel::Channel>(loop_, getAcceptFd(port))), accept_budget_(default_accept_budget), idle_fd_(::open("/dev/null", O_RDONLY | O_CLOEXEC))
         {
             channel_->setReadCallback(std::bind(&Acceptor::handleAccept, this));
+            // io_uring后端直接提交获取连接请求，新连接随可读事件一起交付
+            if (loop_->isCompletionEnabled())
+                channel_->enableCompletion(rs_channel::CompletionOp::Accept);
         }
 
+        // 逐个处理获取到的连接
         void setAcceptCallback(const acceptCallback_t &cb)
         {
             ac_cb_ = cb;
         }
 
+        // 一次处理单次可读事件获取到的所有连接，设置后不再调用逐个处理的回调
+        void setAcceptBatchCallback(const acceptBatchCallback_t &cb)
+        {
+            ac_batch_cb_ = cb;
+        }
+
+        // 设置单次可读事件最多获取的连接数
+        void setAcceptBudget(int budget)
+        {
+            assert(budget > 0);
+            accept_budget_ = budget;
+        }
+
         void enableConcerningAcceptFd()
         {
             channel_->enableConcerningReadFd();
         }
 
+        ~Acceptor()
+        {
+            if (idle_fd_ >= 0)
+                ::close(idle_fd_);
+        }
+
     private:
         // 处理有新连接的回调函数
         void handleAccept()
         {
-            // 获取新连接并交给上层处理
-            int newfd = socket_->accept();
-            if (ac_cb_)
-                ac_cb_(newfd);
+            std::vector<int> fds;
+            if (channel_->getCompletionOp() == rs_channel::CompletionOp::Accept)
+                collectCompletions(fds);
+            else
+                acceptReady(fds);
+
+            if (fds.empty())
+                return;
+
+            // 获取到的连接交给上层处理
+            if (ac_batch_cb_)
+            {
+                ac_batch_cb_(fds);
+                return;
+            }
+            for (int fd : fds)
+            {
+                if (ac_cb_)
+                    ac_cb_(fd);
+                else
+                    ::close(fd);
+            }
+        }
+
+        // 取出获取连接请求完成的新连接，内核已经完成的连接全部交付，不受单次上限限制
+        void collectCompletions(std::vector<int> &fds)
+        {
+            bool exhausted = false;
+            for (const rs_channel::Completion &c : channel_->getCompletions())
+            {
+                if (c.res >= 0)
+                {
+                    fds.push_back(c.res);
+                }
+                else if (c.res == -EMFILE || c.res == -ENFILE)
+                {
+                    exhausted = true;
+                }
+                else if (c.res != -EINTR && c.res != -ECONNABORTED && c.res != -EAGAIN)
+                {
+                    LOG(Level::Warning, "获取客户端连接失败：{}", strerror(-c.res));
+                }
+            }
+
+            // 描述符耗尽时请求已经结束，先丢弃队列中的连接，下一轮再重新提交请求
+            if (exhausted)
+                acceptReady(fds);
+        }
+
+        // 循环获取新连接直到暂无连接或者达到单次上限，获取失败的描述符不交给上层
+        void acceptReady(std::vector<int> &fds)
+        {
+            for (int i = 0; i < accept_budget_; i++)
+            {
+                int newfd = socket_->acceptNonBlock();
+                if (newfd >= 0)
+                {
+                    fds.push_back(newfd);
+                    continue;
+                }
+                if (errno == EINTR || errno == ECONNABORTED)
+                    continue;
+                if (errno == EMFILE || errno == ENFILE)
+                {
+                    if (shedConnection())
+                        continue;
+                }
+                else if (errno != EAGAIN && errno != EWOULDBLOCK)
+                {
+                    LOG(Level::Warning, "获取客户端连接失败：{}", strerror(errno));
+                }
+                break;
+            }
+        }
+
+        // 文件描述符耗尽时释放预留的描述符，获取一个连接后立即关闭再重新预留
+        // 否则连接一直留在队列中，监听套接字持续可读导致事件循环空转
+        bool shedConnection()
+        {
+            if (idle_fd_ < 0)
+                return false;
+
+            ::close(idle_fd_);
+            int fd = socket_->acceptNonBlock();
+            if (fd >= 0)
+                ::close(fd);
+            idle_fd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+            LOG(Level::Warning, "文件描述符耗尽，丢弃新连接");
+
+            return fd >= 0;
         }
 
         // 获取监听套接字文件描述符
@@ -57,9 +176,12 @@ namespace rs_acceptor
         rs_socket::Socket::ptr socket_;                          // 套接字操作
         rs_event_loop_lock_queue::EventLoopLockQueue* loop_; // 监听套接字描述符事件监控
         rs_channel::Channel::ptr channel_;                       // 监听套接字描述符事件管理
+        int accept_budget_;                                      // 单次可读事件最多获取的连接数
+        int idle_fd_;                                            // 预留的文件描述符，描述符耗尽时用于丢弃连接
 
         acceptCallback_t ac_cb_;
+        acceptBatchCallback_t ac_batch_cb_;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
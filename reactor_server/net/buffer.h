@@ -4,7 +4,13 @@
 #include <vector>
 #include <cstdint>
 #include <cassert>
+#include <cerrno>
 #include <string>
+#include <string_view>
+#include <sys/uio.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 namespace rs_buffer
 {
@@ -164,44 +170,38 @@ namespace rs_buffer
             read_move(&(buf[0]), len);
         }
 
-        // 查找\r\n
-        uint64_t getCRLF_1(std::string &buf)
+        // 查找一行数据的结束位置（不拷贝数据）
+        // 返回包含换行符在内的行长度，不存在完整的一行时返回0
+        uint64_t findLineEnd() const
         {
-            return buf.find("\r\n");
+            uint64_t pos = findNewline(getReadPos(), getReadableSize());
+            if (pos == std::string_view::npos)
+                return 0;
+
+            return pos + 1;
         }
 
-        // 查找\n
-        uint64_t getCRLF_2(std::string &buf)
+        // 读取一行数据（返回指向缓冲区的视图，会保存换行符）——不移动指针
+        // 视图只在下一次写入缓冲区之前有效
+        std::string_view readLineView_noMove() const
         {
-            return buf.find("\n");
+            return std::string_view(getReadPos(), findLineEnd());
+        }
+
+        // 读取一行数据（返回指向缓冲区的视图，会保存换行符）——移动指针
+        // 视图只在下一次写入缓冲区之前有效
+        std::string_view readLineView_move()
+        {
+            std::string_view line = readLineView_noMove();
+            moveReadPtr(line.size());
+            return line;
         }
 
         // 读取一行数据（存入字符串，会保存换行符）——不移动指针
+        // 不存在完整的一行时字符串为空
         void readLine_noMove(std::string &buf)
         {
-            // 基于可读部分创建临时字符串
-            std::string readable_data(getReadPos(), getReadPos() + getReadableSize());
-            // 先获取\r\n，找不到再获取\n
-            uint64_t pos = getCRLF_1(readable_data);
-
-            if (pos != std::string::npos)
-            {
-                // 确保不会越界
-                if (pos + 2 <= getReadableSize())
-                {
-                    std::string str(getReadPos(), getReadPos() + pos + 2);
-                    buf = str;
-                }
-            }
-            else
-            {
-                pos = getCRLF_2(readable_data);
-                if (pos != std::string::npos && pos + 1 <= getReadableSize())
-                {
-                    std::string str(getReadPos(), getReadPos() + pos + 1);
-                    buf = str;
-                }
-            }
+            buf.assign(readLineView_noMove());
         }
 
         // 读取一行数据（存入字符串，会保存换行符）——移动指针
@@ -211,6 +211,57 @@ namespace rs_buffer
             moveReadPtr(buf.size());
         }
 
+        // 分散读取文件描述符数据——移动写入指针
+        // 将写位置之后的可写空间与额外缓冲区组成iovec，一次readv直接将数据读入缓冲区
+        // 只有超出可写空间的部分才会落在额外缓冲区中，再拷贝到缓冲区
+        // 返回值与Socket::recv_block保持一致：出错或者对端关闭返回-1，暂无数据返回0
+        ssize_t readv_move(int fd, char *extra, size_t extra_len)
+        {
+            // 没有可读数据时重置位置，使前部空间可以直接用于接收
+            if (getReadableSize() == 0)
+                clear();
+
+            uint64_t writable_size = getBackWritableSize();
+            struct iovec iov[2];
+            iov[0].iov_base = getWritePos();
+            iov[0].iov_len = writable_size;
+            iov[1].iov_base = extra;
+            iov[1].iov_len = extra_len;
+            // 可写空间已经不小于额外缓冲区时不再使用额外缓冲区
+            int iovcnt = (writable_size < extra_len) ? 2 : 1;
+
+            // 被信号打断时重新读取，返回0会被边缘触发模式当作数据已经读完
+            ssize_t ret = 0;
+            do
+            {
+                ret = ::readv(fd, iov, iovcnt);
+            } while (ret < 0 && errno == EINTR);
+            if (ret < 0)
+            {
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    return 0;
+                return -1;
+            }
+            else if (ret == 0)
+            {
+                // 对端正常关闭连接
+                return -1;
+            }
+
+            if (static_cast<uint64_t>(ret) <= writable_size)
+            {
+                moveWritePtr(ret);
+            }
+            else
+            {
+                // 可写空间已经写满，剩余数据从额外缓冲区拷贝
+                moveWritePtr(writable_size);
+                write_move(extra, ret - writable_size);
+            }
+
+            return ret;
+        }
+
         // 确定是否存在指定空间大小
         void setEnoughSpace(uint64_t len)
         {
@@ -265,6 +316,41 @@ namespace rs_buffer
             write_idx_ = 0;
         }
 
+    private:
+        // 查找第一个\n的位置，\r\n结尾的行同样以\n作为结束标志
+        // 优先使用AVX2/SSE2每次比较32/16个字节，剩余不足的部分逐字节比较
+        static uint64_t findNewline(const char *data, uint64_t len)
+        {
+            uint64_t i = 0;
+#if defined(__AVX2__)
+            const __m256i newline32 = _mm256_set1_epi8('\n');
+            for (; i + 32 <= len; i += 32)
+            {
+                __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+                uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline32)));
+                if (mask != 0)
+                    return i + __builtin_ctz(mask);
+            }
+#endif
+#if defined(__SSE2__)
+            const __m128i newline16 = _mm_set1_epi8('\n');
+            for (; i + 16 <= len; i += 16)
+            {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+                uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline16)));
+                if (mask != 0)
+                    return i + __builtin_ctz(mask);
+            }
+#endif
+            for (; i < len; i++)
+            {
+                if (data[i] == '\n')
+                    return i;
+            }
+
+            return std::string_view::npos;
+        }
+
     private:
         std::vector<char> buffer_;
         uint64_t read_idx_;  // 读取起始位置（闭）
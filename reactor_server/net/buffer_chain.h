@@ -0,0 +1,276 @@
+#ifndef __rs_buffer_chain_h__
+#define __rs_buffer_chain_h__
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <cerrno>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
+#include <sys/sendfile.h>
+#include <reactor_server/net/buffer.h>
+
+namespace rs_buffer_chain
+{
+    const size_t slab_size = 16384;       // 单个内存块大小
+    const int max_iovec_count = 1024;     // 单次sendmsg最多使用的iovec个数
+    const size_t max_cached_slabs = 256;  // 内存池最多缓存的空闲内存块个数
+
+    // 固定大小内存块池
+    // 每个事件循环持有一个，非线程安全，只能在事件循环所在线程内使用
+    class SlabPool
+    {
+    public:
+        using ptr = std::shared_ptr<SlabPool>;
+
+        SlabPool() = default;
+
+        SlabPool(const SlabPool &) = delete;
+        SlabPool &operator=(const SlabPool &) = delete;
+
+        // 获取一个内存块，优先复用空闲内存块
+        char *allocate()
+        {
+            if (free_slabs_.empty())
+                return new char[slab_size];
+
+            char *slab = free_slabs_.back();
+            free_slabs_.pop_back();
+            return slab;
+        }
+
+        // 归还内存块，超出缓存上限时直接释放
+        void deallocate(char *slab)
+        {
+            if (free_slabs_.size() < max_cached_slabs)
+                free_slabs_.push_back(slab);
+            else
+                delete[] slab;
+        }
+
+        ~SlabPool()
+        {
+            for (auto slab : free_slabs_)
+                delete[] slab;
+        }
+
+    private:
+        std::vector<char *> free_slabs_; // 空闲内存块
+    };
+
+    // 分段缓冲区：由内存池中固定大小的内存块组成的链表
+    // 追加数据不会触发扩容和数据挪动，发送时一次sendmsg可以发送多个内存块
+    // 链表中还可以插入文件区间，按照追加顺序使用sendfile发送，文件内容不经过用户态
+    // 以及共享的只读数据，与内存块一起通过sendmsg发送，数据本身不拷贝
+    class BufferChain
+    {
+    public:
+        // 共享的只读数据
+        using payload_t = std::shared_ptr<const std::string>;
+
+    private:
+        struct Slab
+        {
+            char *data;        // 内存块或者共享数据的起始位置，文件区间时为空
+            size_t read_idx;   // 读取起始位置（闭），文件区间时为当前文件偏移
+            size_t write_idx;  // 写入起始位置（闭），文件区间时为结束文件偏移
+            int file_fd;       // 文件区间对应的文件描述符，内存块时为-1
+            payload_t payload; // 共享数据，内存块与文件区间时为空
+        };
+
+    public:
+        BufferChain(SlabPool *pool)
+            : pool_(pool), readable_size_(0)
+        {
+        }
+
+        BufferChain(const BufferChain &) = delete;
+        BufferChain &operator=(const BufferChain &) = delete;
+
+        // 获取可读数据大小
+        uint64_t getReadableSize() const
+        {
+            return readable_size_;
+        }
+
+        // 写任意数据——移动写入指针
+        void write_move(const void *data, size_t len)
+        {
+            const char *data1 = static_cast<const char *>(data);
+            while (len > 0)
+            {
+                // 最后一个内存块写满后再申请新的内存块
+                if (slabs_.empty() || !isWritable(slabs_.back()))
+                    slabs_.push_back(Slab{pool_->allocate(), 0, 0, -1, nullptr});
+
+                Slab &slab = slabs_.back();
+                size_t n = std::min(len, slab_size - slab.write_idx);
+                std::copy(data1, data1 + n, slab.data + slab.write_idx);
+                slab.write_idx += n;
+                readable_size_ += n;
+                data1 += n;
+                len -= n;
+            }
+        }
+
+        // 写入字符串数据——移动写入指针
+        void write_move(const std::string &data, size_t len)
+        {
+            write_move(data.data(), len);
+        }
+
+        // 写入其他缓冲区的数据——移动写入指针
+        void write_move(const rs_buffer::Buffer &data)
+        {
+            write_move(data.getReadPos(), data.getReadableSize());
+        }
+
+        // 追加文件区间，缓冲区接管文件描述符，发送完毕或者清理时关闭
+        void write_file(int file_fd, off_t offset, size_t len)
+        {
+            if (len == 0)
+            {
+                ::close(file_fd);
+                return;
+            }
+
+            slabs_.push_back(Slab{nullptr, static_cast<size_t>(offset), static_cast<size_t>(offset) + len, file_fd, nullptr});
+            readable_size_ += len;
+        }
+
+        // 追加共享数据从offset开始的部分，缓冲区持有引用直到发送完毕，数据本身不拷贝
+        void write_payload(const payload_t &payload, size_t offset = 0)
+        {
+            if (offset >= payload->size())
+                return;
+
+            slabs_.push_back(Slab{const_cast<char *>(payload->data()), offset, payload->size(), -1, payload});
+            readable_size_ += payload->size() - offset;
+        }
+
+        // 通过一次sendmsg发送多个内存块中的数据——移动读取指针
+        // 使用MSG_DONTWAIT，套接字处于阻塞模式时也不会阻塞事件循环
+        // 位于最前面的是文件区间时改为通过sendfile发送
+        // 返回值与Socket::send_block保持一致：出错返回-1，暂时无法发送返回0
+        ssize_t writev_move(int fd)
+        {
+            if (readable_size_ == 0)
+                return 0;
+
+            if (slabs_.front().data == nullptr)
+                return sendfile_move(fd);
+
+            struct iovec iov[max_iovec_count];
+            int iovcnt = 0;
+            for (auto it = slabs_.begin(); it != slabs_.end() && iovcnt < max_iovec_count; ++it)
+            {
+                // 文件区间之前的数据必须先发送完毕
+                if (it->data == nullptr)
+                    break;
+                if (it->write_idx == it->read_idx)
+                    continue;
+                iov[iovcnt].iov_base = it->data + it->read_idx;
+                iov[iovcnt].iov_len = it->write_idx - it->read_idx;
+                iovcnt++;
+            }
+
+            struct msghdr msg = {};
+            msg.msg_iov = iov;
+            msg.msg_iovlen = iovcnt;
+            ssize_t ret = ::sendmsg(fd, &msg, MSG_DONTWAIT);
+            if (ret < 0)
+            {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                    return 0;
+                return -1;
+            }
+
+            moveReadPtr(ret);
+            return ret;
+        }
+
+        // 偏移读取指针，已经读完的内存块归还内存池
+        void moveReadPtr(size_t len)
+        {
+            assert(len <= readable_size_);
+            readable_size_ -= len;
+            while (len > 0)
+            {
+                Slab &slab = slabs_.front();
+                size_t n = std::min(len, slab.write_idx - slab.read_idx);
+                slab.read_idx += n;
+                len -= n;
+                // 最后一个未写满的内存块仍然可以继续写入，其余内存块、文件区间与共享数据则不会再写入
+                if (slab.read_idx == slab.write_idx && (!isWritable(slab) || slabs_.size() > 1))
+                    popFront();
+            }
+
+            // 数据全部读完时最后一个内存块也可以归还
+            if (readable_size_ == 0)
+                clear();
+        }
+
+        // 清理缓冲区，所有内存块归还内存池
+        void clear()
+        {
+            while (!slabs_.empty())
+                popFront();
+            readable_size_ = 0;
+        }
+
+        ~BufferChain()
+        {
+            clear();
+        }
+
+    private:
+        // 通过sendfile发送位于最前面的文件区间
+        ssize_t sendfile_move(int fd)
+        {
+            Slab &slab = slabs_.front();
+            off_t offset = static_cast<off_t>(slab.read_idx);
+            ssize_t ret = ::sendfile(fd, slab.file_fd, &offset, slab.write_idx - slab.read_idx);
+            if (ret < 0)
+            {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                    return 0;
+                return -1;
+            }
+            // 文件在发送期间被截断，剩余数据无法再发送
+            if (ret == 0)
+                return -1;
+
+            moveReadPtr(ret);
+            return ret;
+        }
+
+        // 是否是还有剩余空间的内存块
+        static bool isWritable(const Slab &slab)
+        {
+            return slab.data != nullptr && !slab.payload && slab.write_idx < slab_size;
+        }
+
+        void popFront()
+        {
+            Slab &slab = slabs_.front();
+            if (slab.payload)
+                slab.payload.reset();
+            else if (slab.data != nullptr)
+                pool_->deallocate(slab.data);
+            else
+                ::close(slab.file_fd);
+            slabs_.pop_front();
+        }
+
+    private:
+        SlabPool *pool_;           // 所属事件循环的内存池
+        std::deque<Slab> slabs_;   // 内存块链表
+        uint64_t readable_size_;   // 可读数据总大小
+    };
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define __rs_channel_h__
 
 #include <cstdint>
+#include <vector>
 #include <functional>
 #include <sys/epoll.h>
 #include <memory>
@@ -16,13 +17,29 @@ namespace rs_channel
     // 事件处理回调（参数后续设置）
     using event_callback_t = std::function<void()>;
 
+    // io_uring后端中可读事件的完成方式
+    enum class CompletionOp : uint8_t
+    {
+        None,   // 只通知就绪，由回调自行读取
+        Accept, // 多次触发的获取连接请求，完成结果为新连接描述符
+        Recv    // 多次触发的接收请求，完成结果为数据长度，数据位于内核填充的缓冲区中
+    };
+
+    // 读请求的完成结果，res小于0时为负的错误码
+    // data指向的缓冲区只在本轮事件处理期间有效
+    struct Completion
+    {
+        int32_t res;
+        const char *data;
+    };
+
     class Channel : public std::enable_shared_from_this<Channel>
     {
     public:
         using ptr = std::shared_ptr<Channel>;
 
         Channel(rs_event_loop_lock_queue::EventLoopLockQueue* loop, int fd)
-            : fd_(fd), events_(0), revents_(0), loop_(loop)
+            : fd_(fd), events_(0), revents_(0), applied_events_(0), in_poller_(false), pending_update_(false), poll_slot_(0), completion_op_(CompletionOp::None), loop_(loop)
         {
         }
 
@@ -38,6 +55,18 @@ namespace rs_channel
             return static_cast<bool>(events_ & EPOLLOUT);
         }
 
+        // 是否为边缘触发模式
+        bool checkIsEdgeTriggered()
+        {
+            return static_cast<bool>(events_ & EPOLLET);
+        }
+
+        // 启用边缘触发模式，需要在启用事件关心之前设置
+        void enableEdgeTriggered()
+        {
+            events_ |= EPOLLET;
+        }
+
         // 启用读事件关心
         void enableConcerningReadFd()
         {
@@ -74,9 +103,10 @@ namespace rs_channel
         }
 
         // 移动指定文件描述符关心
+        // 移除时同时清空关心的事件，不需要先将事件修改为0再移除
         void removeFd()
         {
-            // 待完善具体操作
+            events_ = 0;
             remove();
         }
 
@@ -160,6 +190,73 @@ namespace rs_channel
             return events_;
         }
 
+        // 是否已经添加到Poller中
+        bool isInPoller()
+        {
+            return in_poller_;
+        }
+
+        void setInPoller(bool in_poller)
+        {
+            in_poller_ = in_poller;
+        }
+
+        // 获取已经通过epoll_ctl生效的事件
+        uint32_t getAppliedEvents()
+        {
+            return applied_events_;
+        }
+
+        void setAppliedEvents(uint32_t events)
+        {
+            applied_events_ = events;
+        }
+
+        // 是否有尚未生效的延迟更新
+        bool isPendingUpdate()
+        {
+            return pending_update_;
+        }
+
+        void setPendingUpdate(bool pending)
+        {
+            pending_update_ = pending;
+        }
+
+        // io_uring后端中该Channel对应的注册项下标
+        uint32_t getPollSlot()
+        {
+            return poll_slot_;
+        }
+
+        void setPollSlot(uint32_t slot)
+        {
+            poll_slot_ = slot;
+        }
+
+        // 设置可读事件的完成方式，需要在启用事件关心之前设置，只在io_uring后端生效
+        void enableCompletion(CompletionOp op)
+        {
+            completion_op_ = op;
+        }
+
+        CompletionOp getCompletionOp()
+        {
+            return completion_op_;
+        }
+
+        // 添加本轮的读请求完成结果，由事件监控后端调用
+        void addCompletion(int32_t res, const char *data)
+        {
+            completions_.push_back(Completion{res, data});
+        }
+
+        // 本轮的读请求完成结果，下一次等待时由事件监控后端清空
+        std::vector<Completion> &getCompletions()
+        {
+            return completions_;
+        }
+
         ~Channel()
         {
             // Channel不负责EventLoop的生命周期，只是使用EventLoop
@@ -169,6 +266,12 @@ namespace rs_channel
         int fd_;           // 指定的文件描述符
         uint32_t events_;  // 关心的事件
         uint32_t revents_; // 已经就绪的事件
+        uint32_t applied_events_; // 已经通过epoll_ctl生效的事件
+        bool in_poller_;   // 是否已经添加到Poller中
+        bool pending_update_; // 是否有尚未生效的延迟更新
+        uint32_t poll_slot_; // io_uring后端中的注册项下标
+        CompletionOp completion_op_; // io_uring后端中可读事件的完成方式
+        std::vector<Completion> completions_; // 本轮的读请求完成结果
 
         event_callback_t read_cb_;  // 读事件回调
         event_callback_t write_cb_; // 写事件回调
@@ -4,6 +4,7 @@
 #include <any>
 #include <reactor_server/base/log.h>
 #include <reactor_server/net/buffer.h>
+#include <reactor_server/net/buffer_chain.h>
 #include <reactor_server/net/socket.h>
 #include <reactor_server/net/event_loop_lock_queue.h>
 
@@ -20,6 +21,9 @@ namespace rs_connection
         Connecting     // 连接建立中
     };
 
+    // 边缘触发模式下单次事件最多读取/发送的数据量，防止单个连接长时间占用事件循环
+    const size_t max_bytes_per_event = 1024 * 1024;
+
     class Connection : public std::enable_shared_from_this<Connection>
     {
     public:
@@ -32,10 +36,15 @@ namespace rs_connection
         using closeCallback_t = std::function<void(const Connection::ptr &)>;
         // 任意事件回调
         using anyEventCallback_t = std::function<void(const Connection::ptr &)>;
+        // 共享的只读发送数据
+        using payload_t = rs_buffer_chain::BufferChain::payload_t;
 
-        Connection(rs_event_loop_lock_queue::EventLoopLockQueue *loop, const std::string &id, int fd)
-            : fd_(fd), id_(id), event_loop_(loop), socket_(std::make_shared<rs_socket::Socket>(fd)), channel_(std::make_shared<rs_channel::Channel>(event_loop_, fd_)), con_status_(ConnectionStatus::Connecting), enable_timeout_release_(false)
+        Connection(rs_event_loop_lock_queue::EventLoopLockQueue *loop, uint64_t id, int fd)
+            : fd_(fd), id_(id), event_loop_(loop), socket_(std::make_shared<rs_socket::Socket>(fd)), channel_(std::make_shared<rs_channel::Channel>(event_loop_, fd_)), out_buffer_(loop->getSlabPool()), con_status_(ConnectionStatus::Connecting), enable_timeout_release_(false), edge_triggered_(false), timeout_ms_(0), last_active_ms_(0), reported_pending_bytes_(0)
         {
+            event_loop_->addConnection();
+            // readv/writev不支持MSG_DONTWAIT，需要将套接字设置为非阻塞
+            socket_->setSocketNonBlock();
             // 设置回调给Channel，但是不启动读事件监控，确保定时任务可以正常使用
             // 防止出现定时任务没有启动之前有读事件发生，此时不存在定时任务导致错误刷新任务
             channel_->setReadCallback(std::bind(&Connection::handleRead, this));
@@ -43,6 +52,9 @@ namespace rs_connection
             channel_->setCloseCallback(std::bind(&Connection::handleClose, this));
             channel_->setErrorCallback(std::bind(&Connection::handleError, this));
             channel_->setAnyCallback(std::bind(&Connection::handleAny, this));
+            // io_uring后端直接提交接收请求，可读事件到达时数据已经读取完毕
+            if (event_loop_->isCompletionEnabled())
+                channel_->enableCompletion(rs_channel::CompletionOp::Recv);
         }
 
         void establishAfterConnected()
@@ -52,14 +64,78 @@ namespace rs_connection
 
         void send(void *data, size_t len)
         {
+            // 在事件循环线程中直接发送，data在发送期间一定有效，不需要额外拷贝
+            if (event_loop_->isInCurrentThread())
+            {
+                sendDataInLoop(static_cast<const char *>(data), len);
+                return;
+            }
+
             /**
              * 因为runTasks可能只是将任务放入队列，并不是立即执行
              * 这就可能出现后续执行sendInLoop时，data数据已经被销毁
-             * 此处构造一个新的buffer，在sendInLoop中使用参数的buffer再构造一个临时buffer用于数据转移到输出缓冲区
+             * 此处构造一个新的buffer，移动到任务中，由sendInLoop将数据转移到输出缓冲区
              */
             rs_buffer::Buffer buffer;
             buffer.write_move(data, len);
-            event_loop_->runTasks(std::bind(&Connection::sendInLoop, this, std::move(buffer)));
+            send(std::move(buffer));
+        }
+
+        // 转移字符串所有权进行发送，数据从用户代码到内核最多只拷贝一次
+        void send(std::string &&data)
+        {
+            if (event_loop_->isInCurrentThread())
+            {
+                sendDataInLoop(data.data(), data.size());
+                return;
+            }
+
+            event_loop_->enqueue([this, data = std::move(data)]()
+                                 { sendDataInLoop(data.data(), data.size()); });
+        }
+
+        // 转移缓冲区所有权进行发送
+        void send(rs_buffer::Buffer &&buffer)
+        {
+            if (event_loop_->isInCurrentThread())
+            {
+                sendInLoop(buffer);
+                return;
+            }
+
+            event_loop_->enqueue([this, buffer = std::move(buffer)]() mutable
+                                 { sendInLoop(buffer); });
+        }
+
+        // 发送共享的只读数据，同一份数据可以发送给多个连接而不需要拷贝
+        // 未能立即发送的部分以引用的方式挂到输出缓冲区
+        void send(const payload_t &payload)
+        {
+            event_loop_->runTasks(std::bind(&Connection::sendPayloadInLoop, this, payload));
+        }
+
+        // 由writer直接向输出缓冲区追加数据，追加完毕后尝试发送，避免先组织成临时字符串再拷贝
+        // writer的参数为输出缓冲区，只能在连接所属的事件循环线程中调用
+        template <typename Writer>
+        void sendInPlace(Writer &&writer)
+        {
+            event_loop_->assertInCurrentThread();
+            bool was_empty = (out_buffer_.getReadableSize() == 0);
+            writer(out_buffer_);
+            // 连接已经释放时不再发送，立即清理追加的数据，writer追加的文件区间随之关闭
+            if (con_status_ == ConnectionStatus::Disconnected)
+            {
+                out_buffer_.clear();
+                return;
+            }
+            flushAppended(was_empty);
+        }
+
+        // 发送文件区间，排在已经缓冲的数据之后，通过sendfile发送
+        // 连接接管文件描述符，发送完毕或者连接释放时关闭
+        void sendFile(int file_fd, off_t offset, size_t len)
+        {
+            event_loop_->runTasks(std::bind(&Connection::sendFileInLoop, this, file_fd, offset, len));
         }
 
         void shutdown()
@@ -72,11 +148,33 @@ namespace rs_connection
             event_loop_->runTasks(std::bind(&Connection::enableTimeoutReleaseInLoop, this, timeout));
         }
 
+        // 在连接建立之前启用超时释放，需要在establishAfterConnected之前调用
+        // 此时连接还没有交给其他线程，直接设置参数，定时任务在连接建立时添加，不需要额外的跨线程任务
+        void presetTimeoutRelease(uint32_t timeout)
+        {
+            assert(con_status_ == ConnectionStatus::Connecting);
+            enable_timeout_release_ = true;
+            timeout_ms_ = static_cast<uint64_t>(timeout) * 1000;
+        }
+
         void disableTimeoutRelease()
         {
             event_loop_->runTasks(std::bind(&Connection::disableTimeoutReleaseInLoop, this));
         }
 
+        // 启用边缘触发模式，需要在establishAfterConnected之前设置
+        // 该模式下读写事件循环处理直到暂时无法读写或者达到单次事件上限，写事件在连接生命周期内保持关心
+        void enableEdgeTriggered()
+        {
+            edge_triggered_ = true;
+        }
+
+        // 设置套接字SO_BUSY_POLL时间（微秒）
+        void setBusyPoll(int busy_poll_us)
+        {
+            socket_->setBusyPoll(busy_poll_us);
+        }
+
         void switchProtocol(const std::any &context, const connectedCallback_t &con_cb, const messageCallback_t &msg_cb, const closeCallback_t &close_cb, const anyEventCallback_t &any_cb)
         {
             event_loop_->assertInCurrentThread();
@@ -119,7 +217,7 @@ namespace rs_connection
             return fd_;
         }
 
-        const std::string getId()
+        uint64_t getId()
         {
             return id_;
         }
@@ -140,28 +238,137 @@ namespace rs_connection
             // 1. 更改连接状态由半连接到完全连接
             assert(con_status_ == ConnectionStatus::Connecting);
             con_status_ = ConnectionStatus::Connected;
+            // 建立之前设置了超时释放时在此添加定时任务
+            if (enable_timeout_release_ && !event_loop_->hasTimer(timer_id_))
+                enableTimeoutReleaseInLoop(static_cast<uint32_t>(timeout_ms_ / 1000));
             // 2. 启用文件描述符可读事件监控
-            channel_->enableConcerningReadFd();
+            // 边缘触发模式下同时启用可写事件监控，之后不再切换
+            if (edge_triggered_)
+            {
+                channel_->enableEdgeTriggered();
+                channel_->enableConcerningReadFd();
+                channel_->enableConcerningWriteFd();
+            }
+            else
+            {
+                channel_->enableConcerningReadFd();
+            }
             // 3. 调用上层回调函数
             if (con_cb_)
                 con_cb_(shared_from_this());
         }
 
-        // 使用传值调用确保临时对象的创建
+        // 发送缓冲区中的可读数据
         void sendInLoop(rs_buffer::Buffer &buffer)
         {
-            // 该接口本身不发送数据，只是将数据放入写入缓冲区，启动读事件监控即可
+            sendDataInLoop(buffer.getReadPos(), buffer.getReadableSize());
+        }
+
+        // 输出缓冲区为空时先尝试直接发送，只有未发送完的部分才放入输出缓冲区并启动写事件监控
+        // 对于可以一次发送完毕的小数据，不需要额外的epoll_ctl和写事件处理
+        void sendDataInLoop(const char *data, size_t len)
+        {
             // 如果连接是待关闭状态就不再发送数据
             if (con_status_ == ConnectionStatus::Disconnected)
                 return;
-            out_buffer_.write_move(buffer);
+
+            ssize_t ret = 0;
+            if (out_buffer_.getReadableSize() == 0)
+            {
+                // 发送出错时不在此处处理，剩余数据放入输出缓冲区后交给写事件处理
+                ret = socket_->send_nonBlock(data, len);
+                if (ret > 0)
+                {
+                    data += ret;
+                    len -= ret;
+                }
+            }
+            if (len == 0)
+                return;
+
+            out_buffer_.write_move(data, len);
+            updatePendingBytes();
+            // 边缘触发模式下出错后不一定还有事件通知，放入任务队列由写事件处理函数释放连接
+            if (ret < 0 && edge_triggered_)
+            {
+                event_loop_->enqueue(std::bind(&Connection::handleWrite, shared_from_this()));
+                return;
+            }
+            // 边缘触发模式下写事件始终关心，套接字重新可写时会收到通知
             if (!channel_->checkIsConcerningWriteFd())
                 channel_->enableConcerningWriteFd();
         }
 
+        void sendFileInLoop(int file_fd, off_t offset, size_t len)
+        {
+            if (con_status_ == ConnectionStatus::Disconnected)
+            {
+                ::close(file_fd);
+                return;
+            }
+
+            bool was_empty = (out_buffer_.getReadableSize() == 0);
+            out_buffer_.write_file(file_fd, offset, len);
+            flushAppended(was_empty);
+        }
+
+        void sendPayloadInLoop(const payload_t &payload)
+        {
+            if (con_status_ == ConnectionStatus::Disconnected)
+                return;
+
+            // 与sendDataInLoop一致，没有待发送数据时先尝试直接发送，剩余部分不拷贝
+            size_t sent = 0;
+            ssize_t ret = 0;
+            if (out_buffer_.getReadableSize() == 0)
+            {
+                ret = socket_->send_nonBlock(payload->data(), payload->size());
+                if (ret > 0)
+                    sent = ret;
+            }
+            if (sent == payload->size())
+                return;
+
+            out_buffer_.write_payload(payload, sent);
+            updatePendingBytes();
+            if (ret < 0 && edge_triggered_)
+            {
+                event_loop_->enqueue(std::bind(&Connection::handleWrite, shared_from_this()));
+                return;
+            }
+            if (!channel_->checkIsConcerningWriteFd())
+                channel_->enableConcerningWriteFd();
+        }
+
+        // 向输出缓冲区追加数据之后调用，追加之前没有待发送数据时先尝试直接发送
+        // 只有未发送完的部分才启动写事件监控
+        void flushAppended(bool was_empty)
+        {
+            ssize_t ret = 0;
+            if (was_empty)
+                ret = flushOutBuffer();
+            updatePendingBytes();
+            if (out_buffer_.getReadableSize() == 0)
+                return;
+
+            if (ret < 0 && edge_triggered_)
+            {
+                event_loop_->enqueue(std::bind(&Connection::handleWrite, shared_from_this()));
+                return;
+            }
+            if (!channel_->checkIsConcerningWriteFd())
+                channel_->enableConcerningWriteFd();
+            continueWriteIfNeeded(ret);
+        }
+
         void releaseInLoop()
         {
-            // 1. 更改连接状态为连接断开
+            // 由定时任务等不持有连接的调用方触发时，内层关闭回调会使连接管理结构释放连接
+            // 在函数开始处持有引用计数，保证函数执行完毕之前连接不会被释放
+            auto self = shared_from_this();
+            // 1. 更改连接状态为连接断开，只在第一次释放时更新事件循环的连接数
+            if (con_status_ != ConnectionStatus::Disconnected)
+                event_loop_->removeConnection();
             con_status_ = ConnectionStatus::Disconnected;
             // 2. 清空Channel的所有回调函数，防止悬空指针访问
             channel_->setReadCallback(nullptr);
@@ -169,14 +376,15 @@ namespace rs_connection
             channel_->setCloseCallback(nullptr);
             channel_->setErrorCallback(nullptr);
             channel_->setAnyCallback(nullptr);
-            // 2. 关闭文件描述符事件监控并移除文件描述符
-            channel_->disableConcerningAll();
+            // 2. 移除文件描述符，同时关闭所有事件监控
             channel_->removeFd();
-            // 3. 关闭描述符
+            // 3. 关闭描述符，并在当前线程内将输出缓冲区的内存块归还内存池
             socket_->close();
+            out_buffer_.clear();
+            updatePendingBytes();
             // 4. 移除定时任务
             if (enable_timeout_release_)
-                if (event_loop_->hasTimer(id_))
+                if (event_loop_->hasTimer(timer_id_))
                     disableTimeoutReleaseInLoop();
             // 5. 调用上层连接断开回调
             // 注意一定要先调用上层的回调，如果调用底层回调会因为释放连接结构导致上层野指针
@@ -185,6 +393,9 @@ namespace rs_connection
             // 6. 调用底层连接断开回调
             if (inner_close_cb_)
                 inner_close_cb_(shared_from_this());
+            // 7. 延迟释放连接，Poller的就绪数组不再持有Channel的引用计数
+            // 保证本轮事件处理结束之前连接以及其Channel不会被释放
+            event_loop_->enqueue([self]() {});
         }
 
         void shutdownInLoop()
@@ -208,18 +419,32 @@ namespace rs_connection
         {
             // 更改标记位
             enable_timeout_release_ = true;
-            // 判断是否存在对应的定时任务，存在即更新，不存在即添加
-            if (event_loop_->hasTimer(id_))
-                event_loop_->refreshTask(id_);
-            else
-                event_loop_->insertTask(id_, timeout, std::bind(&Connection::release, this));
+            timeout_ms_ = static_cast<uint64_t>(timeout) * 1000;
+            last_active_ms_ = event_loop_->getLoopTimeMs();
+            // 判断是否存在对应的定时任务，存在即只更新活跃时间，不存在即添加
+            if (!event_loop_->hasTimer(timer_id_))
+                timer_id_ = event_loop_->insertTask(timeout, std::bind(&Connection::handleTimeout, this));
+        }
+
+        // 定时任务到期时检查最后活跃时间，期间有过活跃就按照剩余时间重新放入时间轮，否则释放连接
+        // 有事件时只需要记录活跃时间，不需要每次都刷新时间轮中的任务
+        void handleTimeout()
+        {
+            uint64_t idle = event_loop_->getLoopTimeMs() - last_active_ms_;
+            if (idle >= timeout_ms_)
+            {
+                release();
+                return;
+            }
+
+            timer_id_ = event_loop_->insertTask(std::chrono::milliseconds(timeout_ms_ - idle), std::bind(&Connection::handleTimeout, this));
         }
 
         void disableTimeoutReleaseInLoop()
         {
             // 更改标记位
             enable_timeout_release_ = false;
-            event_loop_->cancelTask(id_);
+            event_loop_->cancelTask(timer_id_);
         }
 
         void switchProtocolInLoop(const std::any &context, const connectedCallback_t &con_cb, const messageCallback_t &msg_cb, const closeCallback_t &close_cb, const anyEventCallback_t &any_cb)
@@ -242,23 +467,59 @@ namespace rs_connection
                 con_status_ == ConnectionStatus::Disconnecting)
                 return;
 
-            char buffer[65536] = {0};
-            // 读取数据并放入到输入缓冲区中
-            // 再将输入缓冲区中的数据交给消息回调处理
-            ssize_t ret = socket_->recv_nonBlock(buffer, 65535);
-            if (ret < 0)
+            if (channel_->getCompletionOp() == rs_channel::CompletionOp::Recv)
             {
-                // 释放资源后关闭连接
-                shutdownInLoop();
+                handleRecvCompletions();
                 return;
             }
 
+            // 读取数据直接放入到输入缓冲区中，超出可写空间的部分暂存在事件循环的额外缓冲区
+            // 再将输入缓冲区中的数据交给消息回调处理
+            // 边缘触发模式下循环读取直到暂时没有数据或者达到单次事件上限
+            size_t total = 0;
+            while (true)
+            {
+                ssize_t ret = in_buffer_.readv_move(fd_, event_loop_->getExtraBuffer(), event_loop_->getExtraBufferSize());
+                if (ret < 0)
+                {
+                    // 释放资源后关闭连接
+                    shutdownInLoop();
+                    return;
+                }
+                total += ret;
+                if (ret == 0 || !edge_triggered_)
+                    break;
+                if (total >= max_bytes_per_event)
+                {
+                    // 达到上限时可能还有数据，边缘触发不会再次通知，放入任务队列稍后继续读取
+                    event_loop_->enqueue(std::bind(&Connection::handleRead, shared_from_this()));
+                    break;
+                }
+            }
+
             // debug
             // LOG(Level::Debug, "收到数据大小：{}", ret);
 
-            // 写入数据到输入缓冲区
             // 读取为0依旧当做有数据处理，只是写入的数据大小为0
-            in_buffer_.write_move(buffer, ret);
+            if (in_buffer_.getReadableSize() > 0)
+                if (msg_cb_)
+                    msg_cb_(shared_from_this(), in_buffer_);
+        }
+
+        // 接收请求的完成结果已经包含数据，拷贝到输入缓冲区后交给消息回调处理
+        // 结果为0表示对端关闭，小于0表示接收出错，处理已有数据后关闭连接
+        void handleRecvCompletions()
+        {
+            for (const rs_channel::Completion &c : channel_->getCompletions())
+            {
+                if (c.res <= 0)
+                {
+                    shutdownInLoop();
+                    return;
+                }
+                in_buffer_.write_move(const_cast<char *>(c.data), static_cast<size_t>(c.res));
+            }
+
             if (in_buffer_.getReadableSize() > 0)
                 if (msg_cb_)
                     msg_cb_(shared_from_this(), in_buffer_);
@@ -271,8 +532,9 @@ namespace rs_connection
             if (con_status_ == ConnectionStatus::Disconnected)
                 return;
 
-            // 将输出缓冲区中的数据进行发送
-            ssize_t ret = socket_->send_nonBlock(out_buffer_.getReadPos(), out_buffer_.getReadableSize());
+            // 将输出缓冲区中的数据通过writev进行发送，并移动读指针
+            ssize_t ret = flushOutBuffer();
+            updatePendingBytes();
             if (ret < 0)
             {
                 // 判断输入缓冲区是否还有数据需要处理
@@ -281,17 +543,58 @@ namespace rs_connection
                         msg_cb_(shared_from_this(), in_buffer_);
                 // 处理完毕后直接释放连接
                 release();
+                return;
             }
-            // 移动读指针
-            out_buffer_.moveReadPtr(ret);
             // 如果可读空间为0，说明数据已经全部发送完毕，关闭可读事件监控防止持续触发可读事件
             if (out_buffer_.getReadableSize() == 0)
             {
-                channel_->disableConcerningWriteFd();
+                // 边缘触发模式下写事件在连接生命周期内保持关心
+                if (!edge_triggered_)
+                    channel_->disableConcerningWriteFd();
                 // 如果连接状态为待关闭，则释放连接
                 if (con_status_ == ConnectionStatus::Disconnecting)
                     release();
+                return;
+            }
+            continueWriteIfNeeded(ret);
+        }
+
+        // 发送输出缓冲区中的数据，返回本次发送的数据量，出错返回-1
+        // 水平触发模式下只发送一次，边缘触发模式下循环发送直到发送完毕、暂时无法发送或者达到单次事件上限
+        ssize_t flushOutBuffer()
+        {
+            ssize_t total = 0;
+            while (out_buffer_.getReadableSize() > 0)
+            {
+                ssize_t ret = out_buffer_.writev_move(fd_);
+                if (ret < 0)
+                    return -1;
+                if (ret == 0)
+                    break;
+                total += ret;
+                if (!edge_triggered_ || static_cast<size_t>(total) >= max_bytes_per_event)
+                    break;
             }
+
+            return total;
+        }
+
+        // 将输出缓冲区数据量的变化同步到事件循环的负载统计中
+        void updatePendingBytes()
+        {
+            size_t pending = out_buffer_.getReadableSize();
+            if (pending == reported_pending_bytes_)
+                return;
+            event_loop_->addPendingBytes(static_cast<int64_t>(pending) - static_cast<int64_t>(reported_pending_bytes_));
+            reported_pending_bytes_ = pending;
+        }
+
+        // 边缘触发模式下因为达到单次事件上限而停止发送时，套接字仍然可写，不会再次通知
+        // 放入任务队列稍后继续发送
+        void continueWriteIfNeeded(ssize_t sent)
+        {
+            if (edge_triggered_ && out_buffer_.getReadableSize() > 0 && sent > 0 && static_cast<size_t>(sent) >= max_bytes_per_event)
+                event_loop_->enqueue(std::bind(&Connection::handleWrite, shared_from_this()));
         }
 
         void handleClose()
@@ -321,9 +624,9 @@ namespace rs_connection
 
             auto self = shared_from_this();
             
-            // 判断是否启用连接超时释放
+            // 判断是否启用连接超时释放，只记录活跃时间，定时任务到期时再检查
             if (enable_timeout_release_)
-                event_loop_->refreshTask(id_);
+                last_active_ms_ = event_loop_->getLoopTimeMs();
 
             // 调用任意事件回调
             if (any_cb_)
@@ -331,16 +634,21 @@ namespace rs_connection
         }
 
     private:
-        std::string id_;                                           // 连接ID，同时也是定时任务ID
+        uint64_t id_;                                              // 连接ID
         int fd_;                                                   // 管理的文件描述符
         rs_socket::Socket::ptr socket_;                            // 套接字管理结构
         rs_event_loop_lock_queue::EventLoopLockQueue *event_loop_; // 事件监控模块
         rs_channel::Channel::ptr channel_;                         // 事件管理模块
         rs_buffer::Buffer in_buffer_;                              // 输入缓冲区
-        rs_buffer::Buffer out_buffer_;                             // 输出缓冲区
+        rs_buffer_chain::BufferChain out_buffer_;                  // 输出缓冲区
         std::any context_;                                         // 协议上下文管理
         ConnectionStatus con_status_;                              // 连接状态
         bool enable_timeout_release_;                              // 连接超时释放标记
+        bool edge_triggered_;                                      // 是否为边缘触发模式
+        uint64_t timeout_ms_;                                      // 超时释放时间（毫秒）
+        uint64_t last_active_ms_;                                  // 最后一次活跃的时间（毫秒）
+        rs_timing_wheel::TimerId timer_id_;                        // 超时释放定时任务句柄
+        size_t reported_pending_bytes_;                            // 已经同步到事件循环负载统计中的输出缓冲区数据量
 
         connectedCallback_t con_cb_;
         messageCallback_t msg_cb_;
@@ -1,12 +1,16 @@
 #ifndef __rs_event_loop_lock_queue_h__
 #define __rs_event_loop_lock_queue_h__
 
+#include <atomic>
 #include <sys/eventfd.h>
 #include <reactor_server/base/log.h>
 #include <reactor_server/net/channel.h>
 #include <reactor_server/net/poller.h>
 #include <reactor_server/base/error.h>
 #include <reactor_server/net/timing_wheel.h>
+#include <reactor_server/net/buffer_chain.h>
+#include <reactor_server/net/mpsc_queue.h>
+#include <reactor_server/net/loop_stats.h>
 
 namespace rs_event_loop_lock_queue
 {
@@ -14,18 +18,51 @@ namespace rs_event_loop_lock_queue
 
     // 任务类型
     using task_t = std::function<void()>;
+
+    // 每个事件循环共享的额外读缓冲区大小，用于接收超出输入缓冲区可写空间的数据
+    const size_t extra_buffer_size = 65536;
+
+    // 单次从无锁任务队列中取出执行的最大任务数，防止生产者过快导致事件处理饥饿
+    const size_t max_drain_batch = 4096;
+
+    // 事件循环空闲时延迟的衰减周期（微秒），每空闲一个周期延迟减半
+    const uint64_t loop_lag_decay_us = 10000;
+
+    // 任务队列实现方式
+    enum class TaskQueueType
+    {
+        Locked,  // 互斥锁保护的任务数组
+        LockFree // 无锁多生产者单消费者队列
+    };
     
     class EventLoopLockQueue
     {
     public:
         using ptr = std::shared_ptr<EventLoopLockQueue>;
 
-        EventLoopLockQueue()
+        EventLoopLockQueue(TaskQueueType type = TaskQueueType::Locked, rs_poller::PollerType poller_type = rs_poller::PollerType::Epoll)
             :thread_id_(std::this_thread::get_id()),
+            task_queue_type_(type),
+            wakeup_pending_(false),
+            deferred_update_(false),
+            in_loop_iteration_(false),
+            loop_time_ms_(rs_timing_wheel::TimingWheel::getCurrentMs()),
+            active_connections_(0),
+            pending_bytes_(0),
+            loop_lag_us_(0),
+            lag_updated_us_(getCurrentUs()),
+            iteration_begin_us_(0),
+            busy_poll_us_(0),
+            last_active_us_(getCurrentUs()),
+            busy_poll_hits_(0),
+            busy_poll_misses_(0),
+            first_enqueue_us_(0),
             event_fd_(getEventId()),
             event_fd_channel_(std::make_shared<rs_channel::Channel>(this, event_fd_)),
-            poller_(std::make_shared<rs_poller::Poller>()),
-            timing_wheel_(std::make_shared<rs_timing_wheel::TimingWheel>(this))
+            poller_(std::make_shared<rs_poller::Poller>(poller_type)),
+            timing_wheel_(std::make_shared<rs_timing_wheel::TimingWheel>(this)),
+            extra_buffer_(extra_buffer_size),
+            slab_pool_(std::make_shared<rs_buffer_chain::SlabPool>())
         {
             // 为事件通知描述符绑定回调函数，并启用可读事件监控
             event_fd_channel_->setReadCallback(std::bind(&EventLoopLockQueue::readEventId, this));
@@ -37,20 +74,40 @@ namespace rs_event_loop_lock_queue
         {
             while (true)
             {
-                std::vector<rs_channel::Channel::ptr> channels;
                 // 1. 启动事件监控
-                int nfds = poller_->startEpoll(channels);
+                std::vector<rs_channel::Channel *> &channels = pollEvents();
+                uint64_t begin_us = getCurrentUs();
+                iteration_begin_us_.store(begin_us, std::memory_order_relaxed);
+                loop_time_ms_ = begin_us / 1000;
+                in_loop_iteration_ = true;
                 // 2. 进行事件处理
-                std::for_each(channels.begin(), channels.end(), [](const rs_channel::Channel::ptr &channel){
-                    channel->handleEvent();
-                });
+                // 处理过程中其他Channel可能被移除而置空，所以每次都需要重新判断
+                size_t ready = channels.size();
+                for (size_t i = 0; i < channels.size(); i++)
+                {
+                    if (channels[i])
+                        channels[i]->handleEvent();
+                }
 
-                executeAllTasksInQueue();
+                uint64_t events_end_us = getCurrentUs();
+                executeAllTasksInQueue(events_end_us);
+                in_loop_iteration_ = false;
+                // 3. 在下一次等待之前统一生效本轮延迟的事件关心变化
+                applyPendingUpdates();
+                // 4. 记录各阶段耗时，并将本轮处理耗时的滑动平均值作为事件循环延迟
+                uint64_t end_us = getCurrentUs();
+                stats_.recordIteration(last_active_us_, begin_us, events_end_us, end_us, ready);
+                last_active_us_ = end_us;
+                uint64_t busy_us = end_us - begin_us;
+                loop_lag_us_.store((getDecayedLagUs(begin_us) * 7 + busy_us) / 8, std::memory_order_relaxed);
+                lag_updated_us_.store(end_us, std::memory_order_relaxed);
+                iteration_begin_us_.store(0, std::memory_order_relaxed);
             }
         }
 
         // 执行任务，如果在当前线程，就直接执行任务，否则将任务插入到任务队列
-        void runTasks(const task_t &task)
+        // 任务按值接收并移动入队，避免任务捕获的数据被再次拷贝
+        void runTasks(task_t task)
         {
             if(isInCurrentThread())
             {
@@ -60,19 +117,48 @@ namespace rs_event_loop_lock_queue
             }
 
             // 否则插入到任务队列
-            enqueue(task);
+            enqueue(std::move(task));
         }
         
-        void enqueue(const task_t &task)
+        void enqueue(task_t task)
         {
             // 任务入队列
+            if (task_queue_type_ == TaskQueueType::LockFree)
+            {
+                lock_free_tasks_.push(std::move(task));
+            }
+            else
             {
                 std::unique_lock<std::mutex> lock(tasks_mutex_);
-                tasks_.emplace_back(task);
+                tasks_.emplace_back(std::move(task));
             }
 
             // 防止执行流阻塞在epoll_wait，使用时间事件通知的方式触发可读事件跳出epoll_wait
-            writeEventId();
+            // 上一次通知之后任务队列尚未被处理时不需要重复通知，合并多个生产者的通知
+            // 只有负责通知的生产者记录入队时间，用于统计任务等待执行的延迟
+            if (!wakeup_pending_.exchange(true))
+            {
+                first_enqueue_us_.store(getCurrentUs(), std::memory_order_relaxed);
+                writeEventId();
+            }
+        }
+
+        // 获取实际使用的事件监控后端
+        rs_poller::PollerType getPollerType()
+        {
+            return poller_->getPollerType();
+        }
+
+        // 是否以完成方式处理可读事件，Connection与Acceptor据此设置Channel的完成方式
+        bool isCompletionEnabled()
+        {
+            return poller_->isCompletionEnabled();
+        }
+
+        // 获取任务队列实现方式
+        TaskQueueType getTaskQueueType()
+        {
+            return task_queue_type_;
         }
 
         // ? 为什么不需要将任务弹出任务队列
@@ -82,50 +168,224 @@ namespace rs_event_loop_lock_queue
         // {
         // }
 
-        void updateEvent(rs_channel::Channel::ptr channel)
+        void updateEvent(rs_channel::Channel *channel)
         {
+            // 启用延迟更新时，本轮循环中的事件关心变化只记录，在本轮结束时只生效最终结果
+            if (deferred_update_ && in_loop_iteration_)
+            {
+                if (!channel->isPendingUpdate())
+                {
+                    channel->setPendingUpdate(true);
+                    pending_updates_.push_back(channel);
+                }
+                return;
+            }
+
             poller_->updateEvent(channel);
         }
 
-        void removeEvent(rs_channel::Channel::ptr channel)
+        void removeEvent(rs_channel::Channel *channel)
         {
+            // 移除后Channel可能被释放，需要同时丢弃尚未生效的延迟更新
+            if (channel->isPendingUpdate())
+            {
+                channel->setPendingUpdate(false);
+                pending_updates_.erase(std::remove(pending_updates_.begin(), pending_updates_.end(), channel), pending_updates_.end());
+            }
             poller_->removeEvent(channel);
         }
 
-        void cancelTask(const std::string &id)
+        // 启用延迟更新：同一轮循环中多次修改事件关心时只在本轮结束时调用一次epoll_ctl
+        // 使用延迟更新时，Channel在释放之前必须先调用removeFd
+        void enableDeferredUpdate()
+        {
+            runTasks([this]() { deferred_update_ = true; });
+        }
+
+        // 启用忙轮询：每轮处理结束之后的spin_us微秒内以不阻塞的方式反复等待事件，超过之后再阻塞等待
+        // 减少空闲事件循环被唤醒的延迟，代价是忙轮询期间占用CPU，spin_us为0时关闭
+        void enableBusyPoll(uint32_t spin_us)
+        {
+            runTasks([this, spin_us]() { busy_poll_us_ = spin_us; });
+        }
+
+        // 获取忙轮询期间等到事件的次数，可以在任意线程中调用
+        uint64_t getBusyPollHits()
+        {
+            return busy_poll_hits_.load(std::memory_order_relaxed);
+        }
+
+        // 获取忙轮询超时后转为阻塞等待的次数，可以在任意线程中调用
+        uint64_t getBusyPollMisses()
+        {
+            return busy_poll_misses_.load(std::memory_order_relaxed);
+        }
+
+        // 获取事件循环各阶段耗时与分布的快照，可以在任意线程中调用
+        rs_loop_stats::LoopStatsSnapshot getLoopStats()
+        {
+            return stats_.snapshot();
+        }
+
+        // 获取当前事件循环epoll_ctl调用次数，可以在任意线程中调用
+        uint64_t getEpollCtlCount()
+        {
+            return poller_->getEpollCtlCount();
+        }
+
+        void cancelTask(rs_timing_wheel::TimerId id)
         {
             timing_wheel_->cancelTask(id);
         }
 
-        void insertTask(const std::string &id, uint32_t timeout, const rs_schedule_task::ScheduleTask::main_task_t &task)
+        // 新增定时任务并返回任务句柄，只能在EventLoop所在线程内调用
+        // 超时时间以秒为单位
+        rs_timing_wheel::TimerId insertTask(uint32_t timeout, const rs_schedule_task::ScheduleTask::main_task_t &task)
         {
-            timing_wheel_->insertTask(id, timeout, task);
+            return timing_wheel_->insertTask(timeout, task);
         }
 
-        void refreshTask(const std::string &id)
+        // 超时时间以毫秒为单位
+        rs_timing_wheel::TimerId insertTask(std::chrono::milliseconds timeout, const rs_schedule_task::ScheduleTask::main_task_t &task)
+        {
+            return timing_wheel_->insertTask(timeout, task);
+        }
+
+        void refreshTask(rs_timing_wheel::TimerId id)
         {
             timing_wheel_->refreshTask(id);
         }
 
+        // 获取本轮事件处理开始的时间（毫秒），只能在EventLoop所在线程内使用
+        // 每轮只读取一次时钟，连接记录活跃时间时不需要再次读取时钟
+        uint64_t getLoopTimeMs()
+        {
+            return loop_time_ms_;
+        }
+
         // 非线程安全，使用时需要保证在同一线程内
-        bool hasTimer(const std::string &id)
+        bool hasTimer(rs_timing_wheel::TimerId id)
         {
             return timing_wheel_->hasTimer(id);
         }
 
+        // 新连接分配到当前事件循环，可以在任意线程中调用
+        void addConnection()
+        {
+            active_connections_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // 连接释放，只能在EventLoop所在线程内调用
+        void removeConnection()
+        {
+            active_connections_.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        // 累加输出缓冲区中待发送数据量的变化，只能在EventLoop所在线程内调用
+        void addPendingBytes(int64_t delta)
+        {
+            pending_bytes_.store(pending_bytes_.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+
+        // 以下负载统计可以在任意线程中读取，只作为负载均衡的参考值
+        // 获取当前事件循环管理的连接数
+        uint64_t getActiveConnections()
+        {
+            return active_connections_.load(std::memory_order_relaxed);
+        }
+
+        // 获取当前事件循环所有连接输出缓冲区中待发送的数据量
+        int64_t getPendingBytes()
+        {
+            return pending_bytes_.load(std::memory_order_relaxed);
+        }
+
+        // 获取每轮事件处理与任务执行耗时的滑动平均值（微秒），可以在任意线程中调用
+        // 事件循环空闲时按照空闲时长衰减，避免一次耗时较长的处理使空闲的事件循环一直显得繁忙
+        // 正在处理的一轮耗时超过平均值时以本轮已经经过的时间为准
+        uint64_t getLoopLagUs()
+        {
+            return getLoopLagUs(getCurrentUs());
+        }
+
+        // 获取额外读缓冲区，只能在EventLoop所在线程内使用
+        char *getExtraBuffer()
+        {
+            return extra_buffer_.data();
+        }
+
+        size_t getExtraBufferSize()
+        {
+            return extra_buffer_.size();
+        }
+
+        // 获取内存块池，只能在EventLoop所在线程内使用
+        rs_buffer_chain::SlabPool *getSlabPool()
+        {
+            return slab_pool_.get();
+        }
+
         // 断言判断是否在当前线程内
         void assertInCurrentThread()
         {
             assert(std::this_thread::get_id() == thread_id_);
         }
 
-    private:
         // 判断当前是否在EventLoop所在线程
         bool isInCurrentThread()
         {
             return (std::this_thread::get_id() == thread_id_);
         }
-    
+
+    private:
+        // 获取单调时钟时间（微秒），与时间轮使用同一时钟
+        static uint64_t getCurrentUs()
+        {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return static_cast<uint64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+        }
+
+        // 滑动平均值按照距离上一次更新的时长衰减到now时刻的值
+        uint64_t getDecayedLagUs(uint64_t now)
+        {
+            uint64_t lag = loop_lag_us_.load(std::memory_order_relaxed);
+            uint64_t updated = lag_updated_us_.load(std::memory_order_relaxed);
+            uint64_t periods = now > updated ? (now - updated) / loop_lag_decay_us : 0;
+
+            return periods >= 64 ? 0 : lag >> periods;
+        }
+
+        uint64_t getLoopLagUs(uint64_t now)
+        {
+            uint64_t lag = getDecayedLagUs(now);
+            uint64_t begin = iteration_begin_us_.load(std::memory_order_relaxed);
+            if (begin != 0 && now > begin && now - begin > lag)
+                return now - begin;
+
+            return lag;
+        }
+
+        // 等待就绪事件，启用忙轮询且距离上一轮处理结束不超过忙轮询时间时不阻塞
+        std::vector<rs_channel::Channel *> &pollEvents()
+        {
+            if (busy_poll_us_ > 0)
+            {
+                while (getCurrentUs() - last_active_us_ < busy_poll_us_)
+                {
+                    std::vector<rs_channel::Channel *> &channels = poller_->startEpoll(0);
+                    if (!channels.empty())
+                    {
+                        busy_poll_hits_.store(busy_poll_hits_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                        return channels;
+                    }
+                }
+                busy_poll_misses_.store(busy_poll_misses_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+
+            return poller_->startEpoll();
+        }
+
         // 创建并获取事件通知文件描述符
         static int getEventId()
         {
@@ -168,55 +428,111 @@ namespace rs_event_loop_lock_queue
             }
         }
 
+        // 生效所有延迟的事件关心变化，事件没有净变化的Channel不会调用epoll_ctl
+        void applyPendingUpdates()
+        {
+            for (auto channel : pending_updates_)
+            {
+                channel->setPendingUpdate(false);
+                poller_->updateEvent(channel);
+            }
+            pending_updates_.clear();
+        }
+
         // 执行任务队列中所有的任务
-        void executeAllTasksInQueue()
-        {   
-            std::vector<task_t> tasks;
+        void executeAllTasksInQueue(uint64_t now_us)
+        {
+            // 先清除通知标记再取任务，之后入队的任务会重新触发通知
+            wakeup_pending_.store(false);
+            // 入队时间在通知之后写入，极少数情况下会被计入下一次执行，统计值偏大
+            uint64_t enqueue_us = first_enqueue_us_.exchange(0, std::memory_order_relaxed);
+
+            // 批量取出任务，复用执行数组的空间
+            if (task_queue_type_ == TaskQueueType::LockFree)
+            {
+                task_t task;
+                while (running_tasks_.size() < max_drain_batch && lock_free_tasks_.pop(task))
+                    running_tasks_.emplace_back(std::move(task));
+
+                // 本轮未取完的任务留到下一轮处理，确保下一轮不会阻塞在epoll_wait
+                if (!lock_free_tasks_.empty() && !wakeup_pending_.exchange(true))
+                {
+                    first_enqueue_us_.store(now_us, std::memory_order_relaxed);
+                    writeEventId();
+                }
+            }
+            else
             {
                 std::unique_lock<std::mutex> lock(tasks_mutex_);
-                tasks_.swap(tasks);
+                tasks_.swap(running_tasks_);
             }
 
-            std::for_each(tasks.begin(), tasks.end(), [](const task_t &task){
+            if (enqueue_us != 0)
+                stats_.recordDrain(now_us > enqueue_us ? now_us - enqueue_us : 0, running_tasks_.size());
+
+            std::for_each(running_tasks_.begin(), running_tasks_.end(), [](const task_t &task){
                 task();
             });
+            running_tasks_.clear();
         }
 
     private:
         std::thread::id thread_id_; // 当前EventLoop所在线程的线程id
+        TaskQueueType task_queue_type_; // 任务队列实现方式
+        std::atomic<bool> wakeup_pending_; // 是否已经通知且任务队列尚未被处理
+        bool deferred_update_; // 是否启用事件关心延迟更新
+        bool in_loop_iteration_; // 是否处于一轮事件处理与任务执行过程中
+        uint64_t loop_time_ms_; // 本轮事件处理开始的时间（毫秒）
+        std::atomic<uint64_t> active_connections_; // 当前事件循环管理的连接数
+        std::atomic<int64_t> pending_bytes_; // 所有连接输出缓冲区中待发送的数据量
+        std::atomic<uint64_t> loop_lag_us_; // 每轮处理耗时的滑动平均值（微秒）
+        std::atomic<uint64_t> lag_updated_us_; // 上一次更新滑动平均值的时间（微秒）
+        std::atomic<uint64_t> iteration_begin_us_; // 正在处理的一轮开始的时间（微秒），为0表示正在等待事件
+        uint32_t busy_poll_us_; // 忙轮询时间（微秒），为0时不启用
+        uint64_t last_active_us_; // 上一轮处理结束的时间（微秒）
+        std::atomic<uint64_t> busy_poll_hits_; // 忙轮询期间等到事件的次数
+        std::atomic<uint64_t> busy_poll_misses_; // 忙轮询超时后转为阻塞等待的次数
+        std::atomic<uint64_t> first_enqueue_us_; // 触发通知的任务入队时间（微秒），为0表示没有等待中的通知
+        rs_loop_stats::LoopStats stats_; // 各阶段耗时与分布统计
+        std::vector<rs_channel::Channel *> pending_updates_; // 尚未生效的事件关心变化
         int event_fd_; // 事件通知描述符
         rs_channel::Channel::ptr event_fd_channel_; // 事件通知描述符事件监控结构
         rs_poller::Poller::ptr poller_; // 事件监控模块
         std::vector<task_t> tasks_; // 任务队列
         std::mutex tasks_mutex_; // 保护任务队列互斥锁
+        rs_mpsc_queue::MpscQueue<task_t> lock_free_tasks_; // 无锁任务队列
+        std::vector<task_t> running_tasks_; // 本轮待执行的任务
 
         rs_timing_wheel::TimingWheel::ptr timing_wheel_; // 时间轮
+        std::vector<char> extra_buffer_; // 额外读缓冲区，同一线程内所有连接共享
+        rs_buffer_chain::SlabPool::ptr slab_pool_; // 内存块池，同一线程内所有连接的输出缓冲区共享
     };
 }
 
 // 分离实现Channel类中的函数
 void rs_channel::Channel::update()
 {
-    loop_->updateEvent(shared_from_this());
+    loop_->updateEvent(this);
 }
 
 void rs_channel::Channel::remove()
 {
-    loop_->removeEvent(shared_from_this());
+    loop_->removeEvent(this);
 }
 
 // 分离实现TimingWheel中的函数
-void rs_timing_wheel::TimingWheel::cancelTask(const std::string &id)
+void rs_timing_wheel::TimingWheel::cancelTask(TimerId id)
 {
     loop_->runTasks(std::bind(&TimingWheel::cancelTaskInLoop, this, id));
 }
 
-void rs_timing_wheel::TimingWheel::insertTask(const std::string &id, uint32_t timeout, const rs_schedule_task::ScheduleTask::main_task_t &task)
+rs_timing_wheel::TimerId rs_timing_wheel::TimingWheel::insertTask(std::chrono::milliseconds timeout, const rs_schedule_task::ScheduleTask::main_task_t &task)
 {
-    loop_->runTasks(std::bind(&TimingWheel::insertTaskInLoop, this, id, timeout, task));
+    loop_->assertInCurrentThread();
+    return insertTaskInLoop(timeout, task);
 }
 
-void rs_timing_wheel::TimingWheel::refreshTask(const std::string &id)
+void rs_timing_wheel::TimingWheel::refreshTask(TimerId id)
 {
     loop_->runTasks(std::bind(&TimingWheel::refreshTaskInLoop, this, id));
 }
@@ -1,10 +1,11 @@
 #ifndef __rs_http_context_h__
 #define __rs_http_context_h__
 
+#include <algorithm>
 #include <reactor_server/base/log.h>
 #include <reactor_server/net/buffer.h>
 #include <reactor_server/net/http/http_request.h>
-#include <reactor_server/net/http/utils/common_op.h>
+#include <reactor_server/net/http/http_parser.h>
 #include <reactor_server/net/http/utils/url_op.h>
 
 namespace rs_http_context
@@ -20,11 +21,6 @@ namespace rs_http_context
         RecvError
     };
 
-    const int max_request_line_size = 8192; // 8MB数据
-    const std::string params_sep = "&";
-    const std::string key_value_sep = "=";
-    const std::string header_sep = ": ";
-
     class HttpContext
     {
     public:
@@ -55,9 +51,8 @@ namespace rs_http_context
             switch(recv_status_)
             {
                 case ReqRecvStatus::RecvLine:
-                    handleRequestLine(buf);
                 case ReqRecvStatus::RecvHeader:
-                    handleRequestHeader(buf);
+                    handleRequestHead(buf);
                 case ReqRecvStatus::RecvBody:
                     handleRequestBody(buf);
             }
@@ -68,205 +63,95 @@ namespace rs_http_context
             response_status_ = 200;
             recv_status_ = ReqRecvStatus::RecvLine;
             request_.clear();
+            parser_.reset();
         }
 
     private:
-        // 处理缓冲区中关于请求行的数据
-        // 确保缓冲区数据存在一行数据，并且该数据不会过大
-        bool handleRequestLine(rs_buffer::Buffer &buf)
+        // 处理缓冲区中请求行与请求头的数据
+        // 解析器只记录字段位置，请求头完整之前不移动读指针，数据不足时下一次从上次停止的位置继续解析
+        bool handleRequestHead(rs_buffer::Buffer &buf)
         {
-            if (recv_status_ != ReqRecvStatus::RecvLine)
+            if (recv_status_ != ReqRecvStatus::RecvLine && recv_status_ != ReqRecvStatus::RecvHeader)
                 return false;
 
-            // 获取请求行的数据
-            std::string line;
-            buf.readLine_move(line);
-            // 如果数据为空，则分为两种情况：
-            // 1. 不足一行数据，直接返回
-            // 2. 数据过大，不处理
-            if (line.size() == 0)
+            const char *data = buf.getReadPos();
+            rs_http_parser::ParseStatus ret = parser_.parse(data, buf.getReadableSize());
+            if (ret == rs_http_parser::ParseStatus::Error)
             {
-                if (buf.getReadableSize() > max_request_line_size)
-                {
-                    // 请求行数据过大
-                    response_status_ = 414; // URI Too Long
-                    recv_status_ = ReqRecvStatus::RecvError;
-                    return false;
-                }
+                response_status_ = parser_.getErrorStatus();
+                recv_status_ = ReqRecvStatus::RecvError;
+                LOG(Level::Warning, "请求行或请求头格式错误，请求处理失败");
+                return false;
+            }
 
-                // 数据不足一行，返回真表示本次处理结束
+            if (ret == rs_http_parser::ParseStatus::Partial)
+            {
+                // 数据不足，返回真表示本次处理结束
+                if (parser_.isRequestLineDone())
+                    recv_status_ = ReqRecvStatus::RecvHeader;
                 return true;
             }
 
-            // 如果获取到的一行数据过大，也返回错误信息
-            if (line.size() > max_request_line_size)
+            setRequestLine(data);
+            setRequestHeaders(data);
+            buf.moveReadPtr(parser_.getHeadLength());
+            parser_.reset();
+
+            if (!request_.isContentLengthValid())
             {
-                // 请求行数据过大
-                response_status_ = 414; // URI Too Long
+                response_status_ = 400; // Bad Request
                 recv_status_ = ReqRecvStatus::RecvError;
+                LOG(Level::Warning, "Content-Length字段无效，请求处理失败");
                 return false;
             }
 
-            if(!parseHttpRequestLine(line))
-                return false;
-
-            recv_status_ = ReqRecvStatus::RecvHeader;
+            recv_status_ = ReqRecvStatus::RecvBody;
 
             return true;
         }
 
-        // 使用正则表达式针对每一个字段进行获取
-        std::smatch getContentFromRequestLine(const std::string &line)
-        {
-            // (\?(.*))*
-            // 表示满足\?(.*)的字符串可以有1次或者多次
-            // std::regex expr(R"((GET|POST|PUT|DELETE|PATCH|HEAD|OPTIONS|TRACE|CONNECT) (/[^?]*)(\?(.*))* (HTTP/1.[01])(?:\r\n|\n)?)");
-            // 但是上面的写法会有问题，当满足的字符串不存在时，(.*)与()*会产生两个空的捕获组
-            // 所以可以使用(?:...)去掉外部的捕获组
-            // 使用std::regex::icase选项忽略大小写
-            std::regex expr(
-                R"((GET|POST|PUT|DELETE|PATCH|HEAD|OPTIONS|TRACE|CONNECT) (/[^?]*)(?:\?(.*))* (HTTP/1.[01])(?:\r\n|\n)?)", std::regex::icase);
-
-            std::smatch results;
-            if (!std::regex_match(line, results, expr))
-                return std::smatch();
-
-            return results;
-        }
-
         // 将请求行字段设置到HttpRequest对象中
-        bool parseHttpRequestLine(const std::string &line)
+        void setRequestLine(const char *data)
         {
-            // 针对请求行进行字段的获取
-            std::smatch matches = getContentFromRequestLine(line);
-            if (matches.empty())
-            {
-                response_status_ = 400; // Bad Request
-                recv_status_ = ReqRecvStatus::RecvError;
-                LOG(Level::Warning, "请求行字段获取为空，处理失败");
-                return false;
-            }
-
-            // 设置属性
-            std::string method = matches[1].str();
             // 将请求方式全部修改为大写字母
+            std::string method(parser_.getMethod().toView(data));
             std::transform(method.begin(), method.end(), method.begin(), ::toupper);
             request_.setMethod(method);
+
             std::string decode_path;
             // 路径部分并没有规定空格转加号
-            rs_url_op::UrlOp::urlDecode(decode_path, matches[2].str());
+            rs_url_op::UrlOp::urlDecode(decode_path, parser_.getPath().toView(data));
             request_.setPath(decode_path);
-            request_.setVersion(matches[4].str());
+            request_.setVersion(std::string(parser_.getVersion().toView(data)));
 
-            // 处理请求参数
-            // 按照&对参数部分进行分割
-            std::vector<std::string> params;
-            bool ret = rs_common_op::CommonOp::split(params, matches[3].str(), params_sep);
-            // 可能没有参数，不需要处理返回错误
-            // if (!ret)
-            // {
-            //     response_status_ = 400; // Bad Request
-            //     recv_status_ = ReqRecvStatus::RecvError;
-            //     LOG(Level::Warning, "参数错误，请求处理失败");
-            //     return false;
-            // }
-            for (auto &str : params)
+            // 处理请求参数，按照&分割后再按照第一个=分割，忽略键或者值为空的参数
+            std::string_view query = parser_.getQuery().toView(data);
+            while (!query.empty())
             {
-                std::vector<std::string> out;
-                // 按照=进行分割
-                bool ret = rs_common_op::CommonOp::split(out, str, key_value_sep);
-                // 可能没有参数，不需要处理返回错误
-                // if (!ret)
-                // {
-                //     response_status_ = 400; // Bad Request
-                //     recv_status_ = ReqRecvStatus::RecvError;
-                //     LOG(Level::Warning, "参数错误，请求处理失败");
-                //     return false;
-                // }
-
-                if (out.size() >= 2)
-                {
-                    std::string decode_param1;
-                    rs_url_op::UrlOp::urlDecode(decode_param1, out[0]);
-
-                    std::string decode_param2;
-                    rs_url_op::UrlOp::urlDecode(decode_param2, out[1]);
-                    request_.setParam(decode_param1, decode_param2);
-                }
+                size_t sep = query.find('&');
+                std::string_view param = query.substr(0, sep);
+                query = sep == std::string_view::npos ? std::string_view() : query.substr(sep + 1);
+
+                size_t eq = param.find('=');
+                if (eq == 0 || eq == std::string_view::npos || eq + 1 == param.size())
+                    continue;
+
+                // 解码使用的临时字符串随上下文复用，避免每个参数申请内存
+                decode_key_.clear();
+                rs_url_op::UrlOp::urlDecode(decode_key_, param.substr(0, eq));
+                decode_value_.clear();
+                rs_url_op::UrlOp::urlDecode(decode_value_, param.substr(eq + 1));
+                request_.setParam(decode_key_, decode_value_);
             }
-
-            return true;
         }
 
-        // 处理缓冲区中关于请求头的数据
-        bool handleRequestHeader(rs_buffer::Buffer &buf)
+        // 将请求头字段设置到HttpRequest对象中
+        void setRequestHeaders(const char *data)
         {
-            if (recv_status_ != ReqRecvStatus::RecvHeader)
-                return false;
-
-            while (true)
-            {
-                // 获取请求行的数据
-                std::string line;
-                // 注意会读取到换行符
-                buf.readLine_move(line);
-
-                if (line.size() == 0)
-                {
-                    if (buf.getReadableSize() > max_request_line_size)
-                    {
-                        response_status_ = 414; // URI Too Long
-                        recv_status_ = ReqRecvStatus::RecvError;
-                        return false;
-                    }
-
-                    return true;
-                }
-
-                if (line.size() > max_request_line_size)
-                {
-                    response_status_ = 414; // URI Too Long
-                    recv_status_ = ReqRecvStatus::RecvError;
-                    return false;
-                }
-
-                // 找到空行就结束
-                if (line == "\r\n" || line == "\n")
-                    break;
-
-                // 处理当前行数据
-                if(!parseHttpRequestHeader(line))
-                    return false;
-            }
-
-            recv_status_ = ReqRecvStatus::RecvBody;
-
-            return true;
-        }
-
-        // 处理请求头字段
-        bool parseHttpRequestHeader(std::string &line)
-        {
-            // 先处理掉换行符
-            if(line.back() == '\n')
-                line.pop_back();
-            if(line.back() == '\r')
-                line.pop_back();
-
-            std::vector<std::string> key_value;
-            bool ret = rs_common_op::CommonOp::split(key_value, line, header_sep);
-            if (!ret)
-            {
-                response_status_ = 400; // Bad Request
-                recv_status_ = ReqRecvStatus::RecvError;
-                LOG(Level::Warning, "请求头字段参数错误，请求处理失败");
-                return false;
-            }
-
-            if (key_value.size() == 2)
-                request_.setHeader(key_value[0], key_value[1]);
-
-            return true;
+            // 请求头内容不会超过请求头部的总长度，一次预留避免多次扩容
+            request_.reserveHeaders(parser_.getHeadLength());
+            for (auto &header : parser_.getHeaders())
+                request_.setHeader(header.name.toView(data), header.value.toView(data));
         }
 
         // 处理缓冲区中关于请求体字段
@@ -275,7 +160,7 @@ namespace rs_http_context
             if (recv_status_ != ReqRecvStatus::RecvBody)
                 return false;
 
-            // 获取请求体大小
+            // 获取请求体大小，请求头添加时已经解析并缓存
             size_t content_length = request_.getContentLength();
             if (content_length == 0)
             {
@@ -291,17 +176,14 @@ namespace rs_http_context
             {
                 // 说明至少可以满足当前请求体内容
                 recv_status_ = ReqRecvStatus::RecvOk;
-                std::string &body = request_.getBody();
-                std::string out;
-                buf.read_move(out, rest_length);
-                body += out;
+                // 直接从缓冲区追加到请求体，不经过临时字符串
+                request_.getBody().append(buf.getReadPos(), rest_length);
+                buf.moveReadPtr(rest_length);
                 return true;
             }
 
             // 否则当前缓冲区的数据就是小于需要的剩余长度，获取缓冲区所有数据放入请求体
-            std::string &body = request_.getBody();
-            std::string out;
-            body.append(buf.getReadPos(), buf.getReadableSize());
+            request_.getBody().append(buf.getReadPos(), buf.getReadableSize());
             buf.moveReadPtr(buf.getReadableSize());
             // 此时不需要更新状态，因为还需要后续继续读取内容放入请求体
             return true;
@@ -311,6 +193,9 @@ namespace rs_http_context
         int response_status_;                  // 响应状态码
         ReqRecvStatus recv_status_;            // 请求接收状态
         rs_http_request::HttpRequest request_; // HTTP请求对象
+        rs_http_parser::HttpParser parser_;    // 请求行与请求头解析器
+        std::string decode_key_;               // 请求参数名解码结果
+        std::string decode_value_;             // 请求参数值解码结果
     };
 }
 
@@ -0,0 +1,417 @@
+#ifndef __rs_http_parser_h__
+#define __rs_http_parser_h__
+
+#include <array>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <string_view>
+
+namespace rs_http_parser
+{
+    const size_t max_line_size = 8192;   // 请求行与单个请求头的最大长度
+    const size_t max_header_count = 100; // 请求头的最大个数
+    const size_t max_method_size = 16;   // 请求方法的最大长度
+
+    enum class ParseStatus
+    {
+        Partial,  // 数据不足，等待后续数据继续解析
+        Complete, // 请求行与请求头解析完毕
+        Error     // 请求格式错误，错误状态码通过getErrorStatus获取
+    };
+
+    // 字段在待解析数据中的位置，相对于数据起始位置记录，缓冲区扩容或者搬移数据后依旧有效
+    struct Span
+    {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+
+        std::string_view toView(const char *base) const
+        {
+            return std::string_view(base + offset, length);
+        }
+    };
+
+    struct HeaderSpan
+    {
+        Span name;  // 字段名
+        Span value; // 字段值，已经去除首尾空白
+    };
+
+    namespace detail
+    {
+        // 请求头字段名允许的字符（RFC 9110 token）
+        inline const std::array<bool, 256> &getTokenTable()
+        {
+            static const std::array<bool, 256> table = []()
+            {
+                std::array<bool, 256> t{};
+                for (int c = '0'; c <= '9'; c++)
+                    t[c] = true;
+                for (int c = 'a'; c <= 'z'; c++)
+                    t[c] = true;
+                for (int c = 'A'; c <= 'Z'; c++)
+                    t[c] = true;
+                for (const char *p = "!#$%&'*+-.^_`|~"; *p; p++)
+                    t[static_cast<unsigned char>(*p)] = true;
+                return t;
+            }();
+
+            return table;
+        }
+
+        inline bool isTokenChar(char c)
+        {
+            return getTokenTable()[static_cast<unsigned char>(c)];
+        }
+
+        // 请求目标中不允许出现控制字符与空白
+        inline bool isTargetChar(char c)
+        {
+            unsigned char u = static_cast<unsigned char>(c);
+            return u > 0x20 && u != 0x7f;
+        }
+
+        inline bool isUpperOrLower(char c)
+        {
+            return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+        }
+    }
+
+    /**
+     * 可恢复的HTTP/1.x请求行与请求头解析器
+     * 直接在缓冲区可读数据上逐字节推进状态，只记录各字段的位置而不拷贝数据
+     * 数据不足时保留当前状态与已经扫描的位置，下一次调用从上次停止的位置继续，已经扫描过的数据不会重复扫描
+     * 解析完成之前调用方不能移动缓冲区的读指针，解析完成后通过getHeadLength获取需要移动的长度
+     */
+    class HttpParser
+    {
+    public:
+        HttpParser()
+        {
+            headers_.reserve(16);
+        }
+
+        /**
+         * 继续解析数据
+         * data为缓冲区可读数据的起始位置，size为可读数据长度
+         * 每次调用时data之前已经扫描过的部分必须与上一次相同
+         */
+        ParseStatus parse(const char *data, size_t size)
+        {
+            if (state_ == State::Done)
+                return ParseStatus::Complete;
+            if (state_ == State::Failed)
+                return ParseStatus::Error;
+
+            while (pos_ < size)
+            {
+                char c = data[pos_];
+                switch (state_)
+                {
+                case State::LineStart:
+                    // 忽略请求行之前的空行
+                    if (c == '\r' || c == '\n')
+                    {
+                        line_start_ = ++pos_;
+                        break;
+                    }
+                    state_ = State::Method;
+                    // fallthrough
+                case State::Method:
+                    if (c == ' ')
+                    {
+                        method_ = makeSpan(line_start_, pos_);
+                        if (method_.length == 0)
+                            return fail(400);
+                        state_ = State::TargetStart;
+                    }
+                    else if (!detail::isUpperOrLower(c) || pos_ - line_start_ >= max_method_size)
+                    {
+                        return fail(400);
+                    }
+                    pos_++;
+                    break;
+                case State::TargetStart:
+                    // 只接受origin-form形式的请求目标
+                    if (c != '/')
+                        return fail(400);
+                    path_.offset = pos_++;
+                    state_ = State::Path;
+                    break;
+                case State::Path:
+                    if (c == ' ' || c == '?')
+                    {
+                        path_.length = pos_ - path_.offset;
+                        query_ = makeSpan(pos_ + 1, pos_ + 1);
+                        version_.offset = pos_ + 1;
+                        state_ = c == ' ' ? State::Version : State::Query;
+                    }
+                    else if (!detail::isTargetChar(c))
+                    {
+                        return fail(400);
+                    }
+                    pos_++;
+                    break;
+                case State::Query:
+                    if (c == ' ')
+                    {
+                        query_.length = pos_ - query_.offset;
+                        version_.offset = pos_ + 1;
+                        state_ = State::Version;
+                    }
+                    else if (!detail::isTargetChar(c))
+                    {
+                        return fail(400);
+                    }
+                    pos_++;
+                    break;
+                case State::Version:
+                    if (c == '\r' || c == '\n')
+                    {
+                        version_.length = pos_ - version_.offset;
+                        if (!isValidVersion(data + version_.offset, version_.length))
+                            return fail(400);
+                        state_ = State::LineLF;
+                        if (c == '\r')
+                        {
+                            pos_++;
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        // 协议版本固定为8个字符
+                        if (pos_ - version_.offset >= 8)
+                            return fail(400);
+                        pos_++;
+                        break;
+                    }
+                    // fallthrough
+                case State::LineLF:
+                    // 回车之后必须是换行
+                    if (c != '\n')
+                        return fail(400);
+                    state_ = State::HeaderStart;
+                    if (!endLine(++pos_))
+                        return ParseStatus::Error;
+                    break;
+                case State::HeaderStart:
+                    if (c == '\r')
+                    {
+                        state_ = State::HeadLF;
+                        pos_++;
+                        break;
+                    }
+                    if (c == '\n')
+                        return finish(pos_ + 1);
+                    if (headers_.size() >= max_header_count)
+                        return fail(431);
+                    headers_.emplace_back();
+                    headers_.back().name.offset = pos_;
+                    state_ = State::HeaderName;
+                    // fallthrough
+                case State::HeaderName:
+                    if (c == ':')
+                    {
+                        HeaderSpan &header = headers_.back();
+                        header.name.length = pos_ - header.name.offset;
+                        // 字段名不能为空，字段名与冒号之间也不能有空白
+                        if (header.name.length == 0)
+                            return fail(400);
+                        state_ = State::ValueStart;
+                    }
+                    else if (!detail::isTokenChar(c))
+                    {
+                        return fail(400);
+                    }
+                    pos_++;
+                    break;
+                case State::ValueStart:
+                    // 跳过字段值之前的空白
+                    if (c == ' ' || c == '\t')
+                    {
+                        pos_++;
+                        break;
+                    }
+                    headers_.back().value.offset = pos_;
+                    state_ = State::Value;
+                    // fallthrough
+                case State::Value:
+                {
+                    // 字段值内部不需要逐字节处理，直接查找行尾
+                    const char *end = static_cast<const char *>(std::memchr(data + pos_, '\n', size - pos_));
+                    if (end == nullptr)
+                    {
+                        pos_ = size;
+                        break;
+                    }
+                    size_t lf = end - data;
+                    HeaderSpan &header = headers_.back();
+                    size_t value_end = lf;
+                    while (value_end > header.value.offset && isWhiteSpace(data[value_end - 1]))
+                        value_end--;
+                    header.value.length = value_end - header.value.offset;
+                    state_ = State::HeaderStart;
+                    pos_ = lf + 1;
+                    if (!endLine(pos_))
+                        return ParseStatus::Error;
+                    break;
+                }
+                case State::HeadLF:
+                    if (c != '\n')
+                        return fail(400);
+                    return finish(pos_ + 1);
+                default:
+                    break;
+                }
+            }
+
+            // 当前行还没有结束，检查是否已经超过长度限制
+            if (pos_ - line_start_ > max_line_size)
+                return fail(isRequestLineDone() ? 431 : 414);
+
+            return ParseStatus::Partial;
+        }
+
+        // 重置解析状态，保留请求头数组的空间供下一个请求复用
+        void reset()
+        {
+            state_ = State::LineStart;
+            pos_ = 0;
+            line_start_ = 0;
+            head_length_ = 0;
+            error_status_ = 0;
+            method_ = Span();
+            path_ = Span();
+            query_ = Span();
+            version_ = Span();
+            headers_.clear();
+        }
+
+        // 请求行是否已经解析完毕
+        bool isRequestLineDone() const
+        {
+            return state_ > State::LineLF;
+        }
+
+        // 请求行与请求头（包括结尾空行）的总长度，解析完成后有效
+        size_t getHeadLength() const
+        {
+            return head_length_;
+        }
+
+        int getErrorStatus() const
+        {
+            return error_status_;
+        }
+
+        const Span &getMethod() const
+        {
+            return method_;
+        }
+
+        // 请求路径，不包括查询字符串
+        const Span &getPath() const
+        {
+            return path_;
+        }
+
+        // 查询字符串，不包括问号
+        const Span &getQuery() const
+        {
+            return query_;
+        }
+
+        const Span &getVersion() const
+        {
+            return version_;
+        }
+
+        const std::vector<HeaderSpan> &getHeaders() const
+        {
+            return headers_;
+        }
+
+    private:
+        enum class State
+        {
+            LineStart,
+            Method,
+            TargetStart,
+            Path,
+            Query,
+            Version,
+            LineLF,
+            HeaderStart,
+            HeaderName,
+            ValueStart,
+            Value,
+            HeadLF,
+            Done,
+            Failed
+        };
+
+        static Span makeSpan(size_t begin, size_t end)
+        {
+            Span span;
+            span.offset = static_cast<uint32_t>(begin);
+            span.length = static_cast<uint32_t>(end - begin);
+            return span;
+        }
+
+        static bool isWhiteSpace(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        // 协议版本只支持HTTP/1.0与HTTP/1.1，不区分大小写
+        static bool isValidVersion(const char *version, size_t length)
+        {
+            return length == 8 && strncasecmp(version, "HTTP/1.", 7) == 0 && (version[7] == '0' || version[7] == '1');
+        }
+
+        // 一行结束，next为下一行的起始位置
+        bool endLine(size_t next)
+        {
+            // 行尾的换行符不计入长度
+            if (next - line_start_ - 1 > max_line_size)
+            {
+                // 刚结束的是请求行时没有任何请求头
+                fail(headers_.empty() ? 414 : 431);
+                return false;
+            }
+            line_start_ = next;
+            return true;
+        }
+
+        ParseStatus finish(size_t head_length)
+        {
+            head_length_ = head_length;
+            pos_ = head_length;
+            state_ = State::Done;
+            return ParseStatus::Complete;
+        }
+
+        ParseStatus fail(int status)
+        {
+            error_status_ = status;
+            state_ = State::Failed;
+            return ParseStatus::Error;
+        }
+
+    private:
+        State state_ = State::LineStart; // 当前解析状态
+        size_t pos_ = 0;                 // 下一个需要扫描的位置
+        size_t line_start_ = 0;          // 当前行的起始位置
+        size_t head_length_ = 0;         // 请求行与请求头的总长度
+        int error_status_ = 0;           // 解析失败时对应的响应状态码
+        Span method_;                    // 请求方法
+        Span path_;                      // 请求路径
+        Span query_;                     // 查询字符串
+        Span version_;                   // 协议版本
+        std::vector<HeaderSpan> headers_; // 请求头字段
+    };
+}
+
+#endif
@@ -2,65 +2,210 @@
 #define __rs_http_request_h__
 
 #include <regex>
+#include <array>
 #include <string>
-#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <charconv>
 #include <filesystem>
+#include <string_view>
+#include <reactor_server/net/http/utils/common_op.h>
 
 namespace rs_http_request
 {
+    // 内联保存的字段个数，超过时才使用堆上的数组
+    const size_t inline_field_count = 16;
+    const size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * 紧凑的字段表，用于保存请求头与请求参数
+     * 所有字段的名称与值连续存放在同一个字符串中，字段只记录位置，对象拷贝后依旧有效
+     * 清空时保留已经申请的空间，同一个连接上的后续请求在常见情况下不再申请内存
+     */
+    class FieldTable
+    {
+    public:
+        explicit FieldTable(bool ignore_case)
+            : ignore_case_(ignore_case), count_(0)
+        {
+        }
+
+        // 添加字段，返回字段下标
+        size_t add(std::string_view name, std::string_view value)
+        {
+            Field field;
+            field.name_offset = static_cast<uint32_t>(storage_.size());
+            field.name_length = static_cast<uint32_t>(name.size());
+            field.value_offset = static_cast<uint32_t>(storage_.size() + name.size());
+            field.value_length = static_cast<uint32_t>(value.size());
+            storage_.append(name);
+            storage_.append(value);
+
+            if (count_ < inline_field_count)
+                inline_[count_] = field;
+            else
+                overflow_.push_back(field);
+
+            return count_++;
+        }
+
+        // 查找字段下标，同名字段存在多个时返回最后添加的，不存在时返回npos
+        size_t find(std::string_view name) const
+        {
+            for (size_t i = count_; i > 0; i--)
+            {
+                std::string_view field_name = getName(i - 1);
+                if (ignore_case_ ? rs_common_op::CommonOp::isEqualIgnoreCase(field_name, name) : field_name == name)
+                    return i - 1;
+            }
+
+            return npos;
+        }
+
+        // 返回的视图在下一次添加或者清空之前有效
+        std::string_view getName(size_t index) const
+        {
+            const Field &field = getField(index);
+            return std::string_view(storage_.data() + field.name_offset, field.name_length);
+        }
+
+        std::string_view getValue(size_t index) const
+        {
+            const Field &field = getField(index);
+            return std::string_view(storage_.data() + field.value_offset, field.value_length);
+        }
+
+        size_t size() const
+        {
+            return count_;
+        }
+
+        // 预留字段内容的空间
+        void reserve(size_t bytes)
+        {
+            storage_.reserve(bytes);
+        }
+
+        void clear()
+        {
+            storage_.clear();
+            overflow_.clear();
+            count_ = 0;
+        }
+
+    private:
+        struct Field
+        {
+            uint32_t name_offset;
+            uint32_t name_length;
+            uint32_t value_offset;
+            uint32_t value_length;
+        };
+
+        const Field &getField(size_t index) const
+        {
+            return index < inline_field_count ? inline_[index] : overflow_[index - inline_field_count];
+        }
+
+    private:
+        bool ignore_case_;                              // 查找时是否忽略字段名大小写
+        size_t count_;                                  // 字段个数
+        std::string storage_;                           // 字段名与字段值的存储空间
+        std::array<Field, inline_field_count> inline_; // 内联保存的字段
+        std::vector<Field> overflow_;                   // 超出内联个数的字段
+    };
+
     class HttpRequest
     {
     public:
         HttpRequest()
-            :version_("HTTP/1.1")
+            : version_("HTTP/1.1"), headers_(true), params_(false), path_params_(false)
         {
+            resetCachedHeaders();
+        }
 
+        // 添加请求头，常用字段在添加时解析并缓存
+        void setHeader(std::string_view key, std::string_view value)
+        {
+            size_t index = headers_.add(key, value);
+            cacheHeader(key, index);
         }
 
-        void setHeader(const std::string &key, const std::string &value)
+        std::string getHeader(std::string_view key)
         {
-            headers_[key] = value;
+            return std::string(getHeaderView(key));
         }
 
-        std::string getHeader(const std::string &key)
+        // 获取请求头的视图，在下一次添加请求头或者清空请求之前有效
+        std::string_view getHeaderView(std::string_view key) const
         {
-            auto pos = headers_.find(key);
-            if (pos == headers_.end())
-                return "";
+            size_t index = headers_.find(key);
+            if (index == npos)
+                return std::string_view();
 
-            return headers_[key];
+            return headers_.getValue(index);
         }
 
-        bool isInHeaders(const std::string &key)
+        bool isInHeaders(std::string_view key) const
         {
-            auto pos = headers_.find(key);
-            if (pos == headers_.end())
-                return false;
+            return headers_.find(key) != npos;
+        }
 
-            return true;
+        void setParam(std::string_view key, std::string_view value)
+        {
+            params_.add(key, value);
         }
 
-        void setParam(const std::string &key, const std::string &value)
+        std::string getParam(std::string_view key)
         {
-            params_[key] = value;
+            return std::string(getParamView(key));
         }
 
-        std::string getParam(const std::string &key)
+        // 获取请求参数的视图，在下一次添加请求参数或者清空请求之前有效
+        std::string_view getParamView(std::string_view key) const
         {
-            auto pos = params_.find(key);
-            if (pos == params_.end())
-                return "";
+            size_t index = params_.find(key);
+            if (index == npos)
+                return std::string_view();
 
-            return params_[key];
+            return params_.getValue(index);
         }
 
-        bool isInParams(const std::string &key)
+        bool isInParams(std::string_view key) const
         {
-            auto pos = params_.find(key);
-            if (pos == params_.end())
-                return false;
+            return params_.find(key) != npos;
+        }
 
-            return true;
+        // 添加路由匹配得到的路径参数
+        void setPathParam(std::string_view key, std::string_view value)
+        {
+            path_params_.add(key, value);
+        }
+
+        std::string getPathParam(std::string_view key)
+        {
+            return std::string(getPathParamView(key));
+        }
+
+        // 获取路径参数的视图，在下一次添加路径参数或者清空请求之前有效
+        std::string_view getPathParamView(std::string_view key) const
+        {
+            size_t index = path_params_.find(key);
+            if (index == npos)
+                return std::string_view();
+
+            return path_params_.getValue(index);
+        }
+
+        bool isInPathParams(std::string_view key) const
+        {
+            return path_params_.find(key) != npos;
+        }
+
+        // 预留请求头内容的空间
+        void reserveHeaders(size_t bytes)
+        {
+            headers_.reserve(bytes);
         }
 
         void setMethod(const std::string &m)
@@ -76,22 +221,35 @@ namespace rs_http_request
             body_.clear();
             headers_.clear();
             params_.clear();
+            path_params_.clear();
+            resetCachedHeaders();
         }
 
-        size_t getContentLength()
+        // 请求体长度，没有Content-Length字段时为0
+        size_t getContentLength() const
         {
-            if (!isInHeaders("Content-Length"))
-                return 0;
+            return content_length_;
+        }
 
-            return std::stol(headers_["Content-Length"]);
+        // Content-Length字段是否能够解析为非负整数
+        bool isContentLengthValid() const
+        {
+            return content_length_valid_;
         }
 
-        bool isKeepAlive()
+        bool isKeepAlive() const
         {
-            if (isInHeaders("Connection") && headers_["Connection"] == "keep-alive")
-                return true;
+            return keep_alive_;
+        }
 
-            return false;
+        std::string_view getHost() const
+        {
+            return host_index_ == npos ? std::string_view() : headers_.getValue(host_index_);
+        }
+
+        std::string_view getTransferEncoding() const
+        {
+            return transfer_encoding_index_ == npos ? std::string_view() : headers_.getValue(transfer_encoding_index_);
         }
 
         std::string getMethod()
@@ -130,13 +288,57 @@ namespace rs_http_request
         }
 
     private:
-        std::string method_;                                   // 请求方法
-        std::filesystem::path path_;                           // 请求资源路径
-        std::string version_;                                  // 协议版本
-        std::unordered_map<std::string, std::string> headers_; // 请求头
-        std::unordered_map<std::string, std::string> params_;  // 请求参数
-        std::string body_;                                     // 请求体
+        // 解析并缓存常用请求头，同名字段以最后一个为准
+        void cacheHeader(std::string_view key, size_t index)
+        {
+            using rs_common_op::CommonOp;
+
+            if (CommonOp::isEqualIgnoreCase(key, "Content-Length"))
+            {
+                std::string_view value = headers_.getValue(index);
+                size_t length = 0;
+                auto ret = std::from_chars(value.data(), value.data() + value.size(), length);
+                content_length_valid_ = !value.empty() && ret.ec == std::errc() && ret.ptr == value.data() + value.size();
+                content_length_ = content_length_valid_ ? length : 0;
+            }
+            else if (CommonOp::isEqualIgnoreCase(key, "Connection"))
+            {
+                keep_alive_ = CommonOp::isEqualIgnoreCase(headers_.getValue(index), "keep-alive");
+            }
+            else if (CommonOp::isEqualIgnoreCase(key, "Host"))
+            {
+                host_index_ = index;
+            }
+            else if (CommonOp::isEqualIgnoreCase(key, "Transfer-Encoding"))
+            {
+                transfer_encoding_index_ = index;
+            }
+        }
+
+        void resetCachedHeaders()
+        {
+            content_length_ = 0;
+            content_length_valid_ = true;
+            keep_alive_ = false;
+            host_index_ = npos;
+            transfer_encoding_index_ = npos;
+        }
+
+    private:
+        std::string method_;            // 请求方法
+        std::filesystem::path path_;    // 请求资源路径
+        std::string version_;           // 协议版本
+        FieldTable headers_;            // 请求头，字段名不区分大小写
+        FieldTable params_;             // 请求参数
+        FieldTable path_params_;        // 路由匹配得到的路径参数
+        std::string body_;              // 请求体
+
+        size_t content_length_;         // 缓存的Content-Length
+        bool content_length_valid_;     // Content-Length是否有效
+        bool keep_alive_;               // 缓存的Connection是否为keep-alive
+        size_t host_index_;             // Host字段下标
+        size_t transfer_encoding_index_; // Transfer-Encoding字段下标
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -2,13 +2,21 @@
 #define __rs_http_response_h__
 
 #include <string>
+#include <memory>
 #include <unordered_map>
-#include <sstream>
+#include <filesystem>
+#include <string_view>
+#include <unistd.h>
+#include <reactor_server/net/buffer_chain.h>
 #include <reactor_server/net/http/http_request.h>
+#include <reactor_server/net/http/utils/file_cache.h>
 #include <reactor_server/net/http/utils/info_get.h>
 
 namespace rs_http_response
 {
+    // 响应正文不小于该大小时转移所有权挂到输出缓冲区，否则直接拷贝到内存块中
+    const size_t body_attach_threshold = 4096;
+
     class HttpResponse
     {
     public:
@@ -17,8 +25,17 @@ namespace rs_http_response
         {}
 
         HttpResponse(int status)
-            :toRedirect_(false), status_(status)
+            :toRedirect_(false), status_(status), file_fd_(-1), file_size_(0)
+        {
+        }
+
+        // 响应持有文件描述符，不允许拷贝
+        HttpResponse(const HttpResponse &) = delete;
+        HttpResponse &operator=(const HttpResponse &) = delete;
+
+        ~HttpResponse()
         {
+            closeFile();
         }
 
         // 设置响应状态码
@@ -40,12 +57,54 @@ namespace rs_http_response
             setHeader("Content-Type", type);
         }
 
-        // 获取响应正文
-        std::string getBody()
+        // 获取响应正文，返回引用避免拷贝正文
+        const std::string &getBody() const
         {
             return body_;
         }
 
+        // 设置已经打开的文件作为响应正文，发送时通过sendfile直接发送文件内容
+        // 响应接管文件描述符，没有通过releaseFile取走时在清空或者析构时关闭
+        void setFile(int fd, size_t size, const std::string &type = "text/html")
+        {
+            closeFile();
+            file_fd_ = fd;
+            file_size_ = size;
+            setHeader("Content-Type", type);
+        }
+
+        // 是否使用文件作为响应正文
+        bool hasFile()
+        {
+            return file_fd_ >= 0;
+        }
+
+        // 取走文件描述符，之后由调用方负责关闭
+        int releaseFile()
+        {
+            int fd = file_fd_;
+            file_fd_ = -1;
+            return fd;
+        }
+
+        // 设置缓存的文件作为响应正文，响应头中的Content-Type与Content-Length使用缓存中预先生成的内容
+        void setCachedFile(const rs_file_cache::CachedFile::ptr &file)
+        {
+            cached_file_ = file;
+        }
+
+        // 是否使用缓存的文件作为响应正文
+        bool hasCachedFile()
+        {
+            return cached_file_ != nullptr;
+        }
+
+        // 获取文件大小
+        size_t getFileSize()
+        {
+            return file_size_;
+        }
+
         // 添加响应头
         void setHeader(const std::string &key, const std::string &value)
         {
@@ -107,32 +166,101 @@ namespace rs_http_response
             redirect_url_.clear();
             body_.clear();
             headers_.clear();
+            closeFile();
+            file_size_ = 0;
+            cached_file_.reset();
         }
 
+        // 组织HTTP响应字符串
         std::string constructHttpResponseStr(rs_http_request::HttpRequest &req)
         {
+            std::string resp_str;
+            std::string version = req.getVersion();
+            const std::string &status_line = rs_info_get::InfoGet::getStatusLine(status_);
+            size_t size = version.size() + status_line.size() + 2 + body_.size();
+            for (auto &p : headers_)
+                size += p.first.size() + p.second.size() + 4;
+            if (cached_file_)
+                size += cached_file_->headers->size() + cached_file_->size;
+            resp_str.reserve(size);
+
             // 构建响应行
-            std::stringstream resp_str;
-            resp_str << req.getVersion() << " " << std::to_string(status_) << " " << rs_info_get::InfoGet::getStatusDesc(status_) << "\r\n";
+            resp_str += version;
+            resp_str += status_line;
 
             // 构建响应头
-            std::for_each(headers_.begin(), headers_.end(), [&](const std::pair<std::string, std::string> &p){
-                resp_str << p.first << ": " << p.second << "\r\n";
-            });
-
-            resp_str << "\r\n";
+            for (auto &p : headers_)
+            {
+                resp_str += p.first;
+                resp_str += ": ";
+                resp_str += p.second;
+                resp_str += "\r\n";
+            }
+            if (cached_file_)
+                resp_str += *cached_file_->headers;
+            resp_str += "\r\n";
 
             // 构建响应体
-            resp_str << body_;
+            if (cached_file_)
+                resp_str += *cached_file_->body;
+            else
+                resp_str += body_;
+
+            return resp_str;
+        }
+
+        // 将响应行、响应头与响应正文直接写入输出缓冲区，不经过临时字符串
+        // 状态行使用预先生成的字符串，较大的响应正文转移所有权后挂到输出缓冲区，调用后正文为空
+        // 缓存的文件正文以引用的方式挂到输出缓冲区，with_body为假时只写入响应行与响应头
+        void serialize(rs_buffer_chain::BufferChain &out, std::string_view version, bool with_body = true)
+        {
+            const std::string &status_line = rs_info_get::InfoGet::getStatusLine(status_);
+            out.write_move(version.data(), version.size());
+            out.write_move(status_line.data(), status_line.size());
 
-            return resp_str.str();
+            for (auto &p : headers_)
+            {
+                out.write_move(p.first.data(), p.first.size());
+                out.write_move(": ", 2);
+                out.write_move(p.second.data(), p.second.size());
+                out.write_move("\r\n", 2);
+            }
+            if (cached_file_)
+                out.write_move(cached_file_->headers->data(), cached_file_->headers->size());
+            out.write_move("\r\n", 2);
+
+            if (!with_body)
+                return;
+            if (cached_file_)
+                out.write_payload(cached_file_->body);
+            else if (body_.size() >= body_attach_threshold)
+            {
+                out.write_payload(std::make_shared<const std::string>(std::move(body_)));
+                body_.clear();
+            }
+            else if (!body_.empty())
+            {
+                out.write_move(body_.data(), body_.size());
+            }
         }
+
+    private:
+        void closeFile()
+        {
+            if (file_fd_ >= 0)
+                ::close(file_fd_);
+            file_fd_ = -1;
+        }
+
     private:
         int status_; // 响应状态码
         bool toRedirect_; // 是否启用重定向
         std::string redirect_url_; // 重定向地址
         std::string body_; // 响应正文
         std::unordered_map<std::string, std::string> headers_; // 请求头
+        int file_fd_; // 作为响应正文的文件描述符
+        size_t file_size_; // 作为响应正文的文件大小
+        rs_file_cache::CachedFile::ptr cached_file_; // 作为响应正文的缓存文件
     };
 }
 
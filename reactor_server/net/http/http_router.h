@@ -0,0 +1,258 @@
+#ifndef __rs_http_router_h__
+#define __rs_http_router_h__
+
+#include <regex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <string_view>
+#include <reactor_server/base/log.h>
+#include <reactor_server/net/http/http_request.h>
+#include <reactor_server/net/http/http_response.h>
+
+namespace rs_http_router
+{
+    using namespace rs_log_system;
+
+    using handler_t = std::function<void(rs_http_request::HttpRequest &req, rs_http_response::HttpResponse &resp)>;
+    using regex_handler_pair_t = std::pair<std::regex, handler_t>;
+
+    // 正则表达式中有特殊含义的字符，不包含这些字符的正则表达式只能匹配自身
+    const std::string_view regex_meta_chars = ".^$|()[]{}*+?\\";
+
+    // 按照路径分段构建的前缀树路由，不匹配时再按照添加顺序尝试正则表达式路由
+    // 前缀树路由的每一段可以是：
+    // 1. 静态段：/users/list，必须完全相同
+    // 2. 参数段：/users/:id，匹配任意非空的一段，结果以id为名称设置到请求的路径参数中
+    // 3. 通配段：/static/*path，只能作为最后一段，匹配剩余的全部路径（可以为空），名称省略时为*
+    // 同一位置优先匹配静态段，其次是参数段，最后是通配段，匹配失败时回溯
+    class Router
+    {
+    public:
+        // 添加前缀树路由，模式不合法或者与已有路由的参数名冲突时返回假
+        bool addRoute(const std::string &pattern, const handler_t &handler)
+        {
+            if (pattern.empty() || pattern[0] != '/')
+            {
+                LOG(Level::Warning, "路由{}必须以/开头，添加失败", pattern);
+                return false;
+            }
+
+            Node *node = &root_;
+            std::string_view rest = std::string_view(pattern).substr(1);
+            while (true)
+            {
+                size_t sep = rest.find('/');
+                std::string_view segment = rest.substr(0, sep);
+                bool last = sep == std::string_view::npos;
+
+                if (!segment.empty() && segment[0] == '*')
+                {
+                    if (!last)
+                    {
+                        LOG(Level::Warning, "路由{}的通配段只能位于最后，添加失败", pattern);
+                        return false;
+                    }
+                    std::string name = segment.size() > 1 ? std::string(segment.substr(1)) : "*";
+                    if (node->wildcard && node->wildcard_name != name)
+                    {
+                        LOG(Level::Warning, "路由{}与已有路由的通配段名称冲突，添加失败", pattern);
+                        return false;
+                    }
+                    if (!node->wildcard)
+                        node->wildcard = std::make_unique<Node>();
+                    node->wildcard_name = name;
+                    node = node->wildcard.get();
+                    break;
+                }
+
+                if (!segment.empty() && segment[0] == ':')
+                {
+                    std::string name(segment.substr(1));
+                    if (name.empty() || (node->param && node->param_name != name))
+                    {
+                        LOG(Level::Warning, "路由{}的参数段为空或者与已有路由的参数名冲突，添加失败", pattern);
+                        return false;
+                    }
+                    if (!node->param)
+                        node->param = std::make_unique<Node>();
+                    node->param_name = name;
+                    node = node->param.get();
+                }
+                else
+                {
+                    node = node->getOrCreateStatic(segment);
+                }
+
+                if (last)
+                    break;
+                rest = rest.substr(sep + 1);
+            }
+
+            if (node->handler)
+            {
+                LOG(Level::Warning, "路由{}已经存在，使用新的处理函数", pattern);
+            }
+            else
+            {
+                route_count_++;
+            }
+            node->handler = handler;
+
+            return true;
+        }
+
+        // 添加正则表达式路由，只在前缀树路由不匹配时使用，多个正则表达式路由按照添加顺序匹配
+        // 不包含正则表达式特殊字符的路由只能匹配自身，在它之前没有添加过正则表达式路由并且没有相同的静态路由时
+        // 直接作为静态路由加入前缀树，否则可能越过之前添加的能匹配同一路径的正则表达式路由，改变匹配顺序
+        // 以:开头的段在前缀树中是参数段，含有这样的段的路由仍然作为正则表达式只匹配自身
+        void addRegexRoute(const std::string &reg, const handler_t &handler)
+        {
+            if (regex_routes_.empty() && !reg.empty() && reg[0] == '/' && reg.find("/:") == std::string::npos &&
+                reg.find_first_of(regex_meta_chars) == std::string::npos && !hasStaticRoute(reg))
+            {
+                addRoute(reg, handler);
+                return;
+            }
+
+            regex_routes_.emplace_back(std::regex(reg), handler);
+        }
+
+        // 查找并调用路径对应的处理函数，前缀树匹配时将路径参数设置到请求中，没有匹配的路由时返回假
+        bool route(rs_http_request::HttpRequest &req, rs_http_response::HttpResponse &resp) const
+        {
+            std::string path = req.getPath().string();
+            if (!path.empty() && path[0] == '/')
+            {
+                const handler_t *handler = match(&root_, std::string_view(path).substr(1), req);
+                if (handler != nullptr)
+                {
+                    (*handler)(req, resp);
+                    return true;
+                }
+            }
+
+            for (auto &pair : regex_routes_)
+            {
+                if (std::regex_match(path, pair.first))
+                {
+                    pair.second(req, resp);
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // 前缀树路由个数
+        size_t getRouteCount() const
+        {
+            return route_count_;
+        }
+
+        // 正则表达式路由个数
+        size_t getRegexRouteCount() const
+        {
+            return regex_routes_.size();
+        }
+
+    private:
+        struct Node
+        {
+            std::string segment;                        // 静态段内容
+            std::vector<std::unique_ptr<Node>> statics; // 静态子节点，按照段内容排序
+            std::unique_ptr<Node> param;                // 参数子节点
+            std::string param_name;                     // 参数名
+            std::unique_ptr<Node> wildcard;             // 通配子节点
+            std::string wildcard_name;                  // 通配参数名
+            handler_t handler;                          // 处理函数，为空表示当前节点不是一条路由的终点
+
+            Node *getOrCreateStatic(std::string_view seg)
+            {
+                auto pos = findStatic(seg);
+                if (pos != statics.end() && (*pos)->segment == seg)
+                    return pos->get();
+
+                auto node = std::make_unique<Node>();
+                node->segment = std::string(seg);
+                return statics.insert(pos, std::move(node))->get();
+            }
+
+            // 二分查找第一个不小于seg的静态子节点
+            std::vector<std::unique_ptr<Node>>::const_iterator findStatic(std::string_view seg) const
+            {
+                return std::lower_bound(statics.begin(), statics.end(), seg,
+                                        [](const std::unique_ptr<Node> &node, std::string_view s)
+                                        { return std::string_view(node->segment) < s; });
+            }
+        };
+
+        // 匹配剩余的路径，路径参数在回溯返回时才设置，失败的分支不会留下参数
+        static const handler_t *match(const Node *node, std::string_view rest, rs_http_request::HttpRequest &req)
+        {
+            size_t sep = rest.find('/');
+            std::string_view segment = rest.substr(0, sep);
+            bool last = sep == std::string_view::npos;
+            std::string_view next = last ? std::string_view() : rest.substr(sep + 1);
+
+            auto pos = node->findStatic(segment);
+            if (pos != node->statics.end() && (*pos)->segment == segment)
+            {
+                const handler_t *handler = last ? getHandler(pos->get()) : match(pos->get(), next, req);
+                if (handler != nullptr)
+                    return handler;
+            }
+
+            if (node->param && !segment.empty())
+            {
+                const handler_t *handler = last ? getHandler(node->param.get()) : match(node->param.get(), next, req);
+                if (handler != nullptr)
+                {
+                    req.setPathParam(node->param_name, segment);
+                    return handler;
+                }
+            }
+
+            if (node->wildcard && node->wildcard->handler)
+            {
+                req.setPathParam(node->wildcard_name, rest);
+                return &node->wildcard->handler;
+            }
+
+            return nullptr;
+        }
+
+        // 是否已经存在完全由静态段组成的同一路由
+        bool hasStaticRoute(std::string_view path) const
+        {
+            const Node *node = &root_;
+            std::string_view rest = path.substr(1);
+            while (true)
+            {
+                size_t sep = rest.find('/');
+                std::string_view segment = rest.substr(0, sep);
+                auto pos = node->findStatic(segment);
+                if (pos == node->statics.end() || (*pos)->segment != segment)
+                    return false;
+                node = pos->get();
+                if (sep == std::string_view::npos)
+                    return node->handler != nullptr;
+                rest = rest.substr(sep + 1);
+            }
+        }
+
+        static const handler_t *getHandler(const Node *node)
+        {
+            return node->handler ? &node->handler : nullptr;
+        }
+
+    private:
+        Node root_;                                      // 前缀树根节点，对应路径开头的/
+        size_t route_count_ = 0;                         // 前缀树路由个数
+        std::vector<regex_handler_pair_t> regex_routes_; // 正则表达式路由
+    };
+}
+
+#endif
@@ -7,8 +7,10 @@
 #include <reactor_server/net/tcp_server.h>
 #include <reactor_server/net/http/http_response.h>
 #include <reactor_server/net/http/http_context.h>
+#include <reactor_server/net/http/http_router.h>
 #include <reactor_server/net/http/utils/common_op.h>
 #include <reactor_server/net/http/utils/file_op.h>
+#include <reactor_server/net/http/utils/file_cache.h>
 
 namespace rs_http_server
 {
@@ -19,8 +21,8 @@ namespace rs_http_server
     class HttpServer
     {
     public:
-        using handler_t = std::function<void(rs_http_request::HttpRequest &req, rs_http_response::HttpResponse &resp)>;
-        using regex_handler_pair_t = std::pair<std::regex, handler_t>;
+        using handler_t = rs_http_router::handler_t;
+        using regex_handler_pair_t = rs_http_router::regex_handler_pair_t;
 
         HttpServer(int port, uint32_t timeout = default_timeout)
             : server_(port)
@@ -31,28 +33,52 @@ namespace rs_http_server
             server_.enableTimeoutRelease(timeout);
         }
 
-        // 设置GET请求处理映射
+        // 设置GET请求处理映射，reg为正则表达式
         void setGetHandler(const std::string &reg, const handler_t &handler)
         {
-            get_mapping_.emplace_back(reg, handler);
+            get_mapping_.addRegexRoute(reg, handler);
         }
 
-        // 设置POST请求处理映射
+        // 设置GET请求路由，支持:参数段与*通配段，优先于正则表达式匹配
+        void setGetRoute(const std::string &pattern, const handler_t &handler)
+        {
+            get_mapping_.addRoute(pattern, handler);
+        }
+
+        // 设置POST请求处理映射，reg为正则表达式
         void setPostHandler(const std::string &reg, const handler_t &handler)
         {
-            post_mapping_.emplace_back(reg, handler);
+            post_mapping_.addRegexRoute(reg, handler);
+        }
+
+        // 设置POST请求路由，支持:参数段与*通配段，优先于正则表达式匹配
+        void setPostRoute(const std::string &pattern, const handler_t &handler)
+        {
+            post_mapping_.addRoute(pattern, handler);
         }
 
-        // 设置PUT请求处理映射
+        // 设置PUT请求处理映射，reg为正则表达式
         void setPutHandler(const std::string &reg, const handler_t &handler)
         {
-            put_mapping_.emplace_back(reg, handler);
+            put_mapping_.addRegexRoute(reg, handler);
         }
 
-        // 设置DELETE请求处理映射
+        // 设置PUT请求路由，支持:参数段与*通配段，优先于正则表达式匹配
+        void setPutRoute(const std::string &pattern, const handler_t &handler)
+        {
+            put_mapping_.addRoute(pattern, handler);
+        }
+
+        // 设置DELETE请求处理映射，reg为正则表达式
         void setDeleteHandler(const std::string &reg, const handler_t &handler)
         {
-            delete_mapping_.emplace_back(reg, handler);
+            delete_mapping_.addRegexRoute(reg, handler);
+        }
+
+        // 设置DELETE请求路由，支持:参数段与*通配段，优先于正则表达式匹配
+        void setDeleteRoute(const std::string &pattern, const handler_t &handler)
+        {
+            delete_mapping_.addRoute(pattern, handler);
         }
 
         // 设置根目录
@@ -62,12 +88,75 @@ namespace rs_http_server
             base_dir_ = path;
         }
 
+        /**
+         * 启用静态文件缓存，需要在startServer之前调用
+         * 不超过max_file_size的静态文件读入内存后在所有线程间共享，命中时不再打开文件
+         * 文件变化通过主事件循环监控的inotify描述符通知，缓存立即失效
+         */
+        void enableFileCache(size_t capacity = rs_file_cache::default_cache_capacity, size_t max_file_size = rs_file_cache::default_max_file_size)
+        {
+            file_cache_ = std::make_shared<rs_file_cache::FileCache>(capacity, max_file_size);
+            if (file_cache_->getNotifyFd() < 0)
+                return;
+            notify_channel_ = std::make_shared<rs_channel::Channel>(server_.getBaseLoop(), file_cache_->getNotifyFd());
+            notify_channel_->setReadCallback(std::bind(&rs_file_cache::FileCache::handleNotify, file_cache_.get()));
+            notify_channel_->enableConcerningReadFd();
+        }
+
+        // 静态文件缓存，未启用时为空
+        rs_file_cache::FileCache::ptr getFileCache()
+        {
+            return file_cache_;
+        }
+
         // 设置线程数量
         void setThreadNum(int num)
         {
             server_.setThreadNum(num);
         }
 
+        // 新连接使用边缘触发模式
+        void enableEdgeTriggered()
+        {
+            server_.enableEdgeTriggered();
+        }
+
+        // 设置新连接分配从属事件循环的策略
+        void setLoadBalancePolicy(rs_loop_thread_pool::LoadBalancePolicy policy)
+        {
+            server_.setLoadBalancePolicy(policy);
+        }
+
+        // 设置从属事件循环的事件监控后端
+        void setPollerType(rs_poller::PollerType type)
+        {
+            server_.setPollerType(type);
+        }
+
+        // 处理连接的事件循环启用忙轮询
+        void enableBusyPoll(uint32_t spin_us, int so_busy_poll_us = 0)
+        {
+            server_.enableBusyPoll(spin_us, so_busy_poll_us);
+        }
+
+        // 所有事件循环启用事件关心延迟更新
+        void enableDeferredEventUpdate()
+        {
+            server_.enableDeferredEventUpdate();
+        }
+
+        // 每个事件循环各自监听端口并获取连接
+        void enableReusePortAccept()
+        {
+            server_.enableReusePortAccept();
+        }
+
+        // 设置单次可读事件最多获取的连接数
+        void setAcceptBudget(int budget)
+        {
+            server_.setAcceptBudget(budget);
+        }
+
         // 启动服务器
         void startServer()
         {
@@ -77,6 +166,29 @@ namespace rs_http_server
     private:
         // 静态资源处理
         void staticResourceHandler(rs_http_request::HttpRequest &req, rs_http_response::HttpResponse &resp)
+        {
+            std::filesystem::path real_path = getRealPath(req);
+            // 此时请求中一定是静态资源
+            // 不读取文件内容，先打开文件再通过描述符获取大小，保证大小与发送的文件一致
+            // 发送响应时通过sendfile直接发送文件，任何一步失败都返回404
+            int fd = rs_file_op::FileOp::openFile(real_path);
+            if (fd < 0)
+            {
+                resp.setStatus(404);
+                return;
+            }
+            size_t size = 0;
+            if (!rs_file_op::FileOp::getFileSize(fd, size))
+            {
+                ::close(fd);
+                resp.setStatus(404);
+                return;
+            }
+            resp.setFile(fd, size, rs_info_get::InfoGet::getMimeType(rs_file_op::FileOp::getExtensionName(real_path)));
+        }
+
+        // 获取请求资源在根目录下的实际路径
+        std::filesystem::path getRealPath(rs_http_request::HttpRequest &req)
         {
             std::filesystem::path req_path = req.getPath();
             std::filesystem::path real_path = base_dir_ / req_path;
@@ -88,32 +200,34 @@ namespace rs_http_server
                 real_path = base_dir_.string() + req_path.string();
             if (real_path.string().back() == '/')
                 real_path /= "index.html";
-            // 此时请求中一定是静态资源
-            // 读取文件内容
-            std::string body;
-            bool ret = rs_file_op::FileOp::readFile(real_path, body);
-            if (!ret)
-                return;
 
-            resp.setBody(body, rs_info_get::InfoGet::getMimeType(rs_file_op::FileOp::getExtensionName(real_path)));
+            return real_path;
         }
 
-        // 动态资源处理
-        void dynamicResourceHandler(rs_http_request::HttpRequest &req, rs_http_response::HttpResponse &resp, std::vector<regex_handler_pair_t> &router)
+        // 从静态文件缓存中获取资源，命中时不需要任何文件系统调用
+        bool cachedResourceHandler(rs_http_request::HttpRequest &req, rs_http_response::HttpResponse &resp, rs_file_cache::UncachedReason &reason)
         {
-            for (auto &pair : router)
-            {
-                std::string path = req.getPath().string();
-                std::smatch matches;
-                // 正则匹配
-                if (std::regex_match(path, matches, pair.first))
-                {
-                    pair.second(req, resp);
-                    return;
-                }
-            }
+            if (!file_cache_ || base_dir_.empty())
+                return false;
+            if (req.getMethod() != "GET" && req.getMethod() != "HEAD")
+                return false;
+            if (!rs_common_op::CommonOp::isValidResourcePath(req.getPath()))
+                return false;
 
-            resp.setStatus(404);
+            std::filesystem::path real_path = getRealPath(req);
+            auto file = file_cache_->get(real_path.string(), rs_info_get::InfoGet::getMimeType(rs_file_op::FileOp::getExtensionName(real_path)), &reason);
+            if (!file)
+                return false;
+            resp.setCachedFile(file);
+
+            return true;
+        }
+
+        // 动态资源处理
+        void dynamicResourceHandler(rs_http_request::HttpRequest &req, rs_http_response::HttpResponse &resp, rs_http_router::Router &router)
+        {
+            if (!router.route(req, resp))
+                resp.setStatus(404);
         }
 
         // 构建错误响应
@@ -153,6 +267,10 @@ namespace rs_http_server
         // 发送HTTP响应
         void sendResponse(const rs_connection::Connection::ptr &con, rs_http_request::HttpRequest &req, rs_http_response::HttpResponse &resp)
         {
+            // 文件正文在静态资源处理时已经打开，大小来自同一个文件描述符
+            if (resp.hasFile())
+                resp.setHeader("Content-Length", std::to_string(resp.getFileSize()));
+
             // 设置长连接或者短连接属性
             if (req.isKeepAlive())
                 resp.setHeader("Connection", "keep-alive");
@@ -160,20 +278,26 @@ namespace rs_http_server
                 resp.setHeader("Connection", "close");
 
             // 设置内容MIME和内容大小
-            if (!resp.getBody().empty() && !resp.isInHeaders("Content-Length"))
-                resp.setHeader("Content-Length", std::to_string(resp.getBody().size()));
-            if (!resp.getBody().empty() && !resp.isInHeaders("Content-Type"))
+            size_t body_size = resp.getBody().size();
+            if (body_size > 0 && !resp.isInHeaders("Content-Length"))
+                resp.setHeader("Content-Length", std::to_string(body_size));
+            if (body_size > 0 && !resp.isInHeaders("Content-Type"))
                 resp.setHeader("Content-Type", rs_info_get::InfoGet::getMimeType(""));
 
             // 是否设置重定向
             if (resp.isRedirectEnabled())
                 resp.setHeader("Location", resp.getRedirectUrl());
 
-            // 根据HttpResponse组织HTTP响应字符串
-            std::string resp_str = resp.constructHttpResponseStr(req);
-
-            // 发送响应
-            con->send((void *)(resp_str.c_str()), resp_str.size());
+            // 响应直接写入连接的输出缓冲区，文件正文作为文件区间追加在响应头之后
+            // HEAD请求只需要响应头
+            std::string version = req.getVersion();
+            bool head_only = (req.getMethod() == "HEAD");
+            con->sendInPlace([&](rs_buffer_chain::BufferChain &out)
+                             {
+                resp.serialize(out, version, !head_only);
+                // HEAD请求不取走文件描述符，由响应析构时关闭
+                if (resp.hasFile() && !head_only)
+                    out.write_file(resp.releaseFile(), 0, resp.getFileSize()); });
         }
 
         // 判断是否是静态资源请求
@@ -192,17 +316,8 @@ namespace rs_http_server
             if (!rs_common_op::CommonOp::isValidResourcePath(req.getPath()))
                 return false;
 
-            std::filesystem::path req_path = req.getPath();
-            std::filesystem::path real_path = base_dir_ / req_path;
-            // 如果请求路径为/，则直接返回根目录
-            // 当右操作数是绝对路径时（以/开头），它会替换左操作数，而不是拼接。这是std::filesystem::path的标准行为
-            if(req_path.string() == "/")
-                real_path = base_dir_.string() + "/";
-            else if (!req_path.empty() && req_path.string()[0] == '/')
-                real_path = base_dir_.string() + req_path.string();
-            if (real_path.string().back() == '/')
-                real_path /= "index.html";
-            
+            std::filesystem::path real_path = getRealPath(req);
+
             // 判断指定路径是否是普通文件
             if (!rs_file_op::FileOp::isRegularFile(real_path))
                 return false;
@@ -213,8 +328,13 @@ namespace rs_http_server
         // 根据请求类型查找映射表
         void getMapping(rs_http_request::HttpRequest &req, rs_http_response::HttpResponse &resp)
         {
-            // 默认情况下，认为都是静态资源请求
-            if (isStaticResourceRequest(req))
+            // 默认情况下，认为都是静态资源请求，优先使用缓存的文件
+            // 缓存已经确定的过大文件直接通过sendfile发送，确定不是普通文件的路径直接交给动态路由
+            rs_file_cache::UncachedReason reason = rs_file_cache::UncachedReason::Unknown;
+            if (cachedResourceHandler(req, resp, reason))
+                return;
+            if (reason == rs_file_cache::UncachedReason::TooLarge ||
+                (reason == rs_file_cache::UncachedReason::Unknown && isStaticResourceRequest(req)))
             {
                 staticResourceHandler(req, resp);
                 return;
@@ -304,12 +424,13 @@ namespace rs_http_server
     private:
         rs_tcp_server::TcpServer server_;
         std::filesystem::path base_dir_;
-        // 模版参数1表示一个正则表达式
-        // 模版参数2表示映射函数
-        std::vector<regex_handler_pair_t> get_mapping_;      // GET请求映射
-        std::vector<regex_handler_pair_t> post_mapping_;     // POST请求映射
-        std::vector<regex_handler_pair_t> put_mapping_;    // PUT请求映射
-        std::vector<regex_handler_pair_t> delete_mapping_; // DELETE请求映射
+        // 先按照前缀树路由匹配，不匹配时再按照添加顺序匹配正则表达式
+        rs_http_router::Router get_mapping_;    // GET请求映射
+        rs_http_router::Router post_mapping_;   // POST请求映射
+        rs_http_router::Router put_mapping_;    // PUT请求映射
+        rs_http_router::Router delete_mapping_; // DELETE请求映射
+        rs_file_cache::FileCache::ptr file_cache_;  // 静态文件缓存
+        rs_channel::Channel::ptr notify_channel_;   // 监控静态文件变化的inotify描述符事件管理
     };
 }
 
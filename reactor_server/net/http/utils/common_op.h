@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <string_view>
+#include <strings.h>
 #include <reactor_server/base/log.h>
 
 namespace rs_common_op
@@ -45,6 +46,12 @@ namespace rs_common_op
             return out.size();
         }
 
+        // 不区分大小写比较两个字符串
+        static bool isEqualIgnoreCase(std::string_view a, std::string_view b)
+        {
+            return a.size() == b.size() && strncasecmp(a.data(), b.data(), a.size()) == 0;
+        }
+
         // 资源有效路径检查
         // 遇到前往上一级的标记就对目录层级进行减一，否则加一，任意一次目录层级减少到负数就返回假
         // 否则返回真
@@ -0,0 +1,448 @@
+#ifndef __rs_file_cache_h__
+#define __rs_file_cache_h__
+
+#include <list>
+#include <iterator>
+#include <algorithm>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#include <reactor_server/base/log.h>
+
+namespace rs_file_cache
+{
+    using namespace rs_log_system;
+
+    const size_t default_cache_capacity = 64 * 1024 * 1024; // 缓存文件内容的总大小上限
+    const size_t default_max_file_size = 1024 * 1024;       // 单个文件超过该大小时不缓存，仍然使用sendfile发送
+    const uint64_t default_check_interval_ms = 1000;        // 没有inotify监控的文件检查修改时间的间隔
+    const size_t default_max_uncached_entries = 4096;       // 记录不缓存原因的路径数上限
+    const uint32_t notify_mask = IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF;
+
+    // 文件没有被缓存的原因
+    enum class UncachedReason
+    {
+        Unknown,    // 未知或者暂时的原因（例如读取期间文件被截断），下一次获取时重新读取
+        NotRegular, // 文件不存在或者不是普通文件
+        TooLarge    // 普通文件但是超过单个文件大小上限
+    };
+
+    // 缓存的文件，创建后不再修改，可以在多个线程中同时使用
+    struct CachedFile
+    {
+        using ptr = std::shared_ptr<const CachedFile>;
+
+        std::shared_ptr<const std::string> body;    // 文件内容
+        std::shared_ptr<const std::string> headers; // 预先生成的Content-Type与Content-Length响应头
+        size_t size;                                // 文件大小
+        struct timespec mtime;                      // 缓存时文件的修改时间
+        ino_t inode;                                // 缓存时文件的inode
+    };
+
+    /**
+     * 静态文件缓存，以文件的实际路径为键，按照最近最少使用的顺序淘汰，保证缓存文件内容的总大小不超过上限
+     * 文件优先通过inotify监控变化，变化时立即失效，命中时不需要任何文件系统调用
+     * inotify不可用或者添加监控失败的文件退化为间隔一段时间检查一次修改时间
+     * 不存在、不是普通文件或者过大的路径同样记录下来，检查间隔内直接返回原因，不再打开文件
+     * 所有接口都可以在任意线程中调用
+     */
+    class FileCache
+    {
+    public:
+        using ptr = std::shared_ptr<FileCache>;
+
+        FileCache(size_t capacity = default_cache_capacity, size_t max_file_size = default_max_file_size)
+            : capacity_(capacity), max_file_size_(std::min(max_file_size, capacity)), total_bytes_(0), check_interval_ms_(default_check_interval_ms), max_uncached_entries_(default_max_uncached_entries), hits_(0), misses_(0), uncached_hits_(0)
+        {
+            notify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (notify_fd_ < 0)
+                LOG(Level::Warning, "inotify不可用，静态文件缓存通过修改时间检查文件变化");
+        }
+
+        FileCache(const FileCache &) = delete;
+        FileCache &operator=(const FileCache &) = delete;
+
+        ~FileCache()
+        {
+            if (notify_fd_ >= 0)
+                ::close(notify_fd_);
+        }
+
+        /**
+         * 获取文件，未缓存时读取文件并加入缓存，content_type为文件的MIME类型
+         * 文件不存在、不是普通文件或者超过单个文件大小上限时返回空，reason不为空时写入原因
+         */
+        CachedFile::ptr get(const std::string &path, const std::string &content_type, UncachedReason *reason = nullptr)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto pos = entries_.find(path);
+                if (pos != entries_.end() && isFresh(pos->second))
+                {
+                    lru_.splice(lru_.begin(), lru_, pos->second.lru_pos);
+                    hits_.fetch_add(1, std::memory_order_relaxed);
+                    return pos->second.file;
+                }
+                // 文件已经变化，移除旧的缓存
+                if (pos != entries_.end())
+                    erase(pos);
+
+                auto uncached = uncached_.find(path);
+                if (uncached != uncached_.end() && isStillUncached(uncached->first, uncached->second))
+                {
+                    uncached_hits_.fetch_add(1, std::memory_order_relaxed);
+                    if (reason)
+                        *reason = uncached->second.reason;
+                    return nullptr;
+                }
+                if (uncached != uncached_.end())
+                    eraseUncached(uncached);
+            }
+
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            // 读取文件时不持有锁，不阻塞其他线程的命中
+            UncachedEntry uncached;
+            CachedFile::ptr file = load(path, content_type, uncached);
+            if (!file)
+            {
+                if (reason)
+                    *reason = uncached.reason;
+                if (uncached.reason != UncachedReason::Unknown)
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    insertUncached(path, uncached);
+                }
+                return nullptr;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            // 其他线程已经加入了同一个文件
+            auto pos = entries_.find(path);
+            if (pos != entries_.end())
+                erase(pos);
+            insert(path, file);
+
+            return file;
+        }
+
+        // 处理inotify事件，使发生变化的文件缓存失效，只能在一个线程中调用
+        void handleNotify()
+        {
+            alignas(struct inotify_event) char buf[4096];
+            while (true)
+            {
+                ssize_t n = ::read(notify_fd_, buf, sizeof(buf));
+                if (n <= 0)
+                    break;
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (char *p = buf; p < buf + n;)
+                {
+                    auto event = reinterpret_cast<struct inotify_event *>(p);
+                    invalidate(event->wd, (event->mask & IN_IGNORED) != 0);
+                    p += sizeof(struct inotify_event) + event->len;
+                }
+            }
+        }
+
+        // inotify文件描述符，不可用时返回-1
+        int getNotifyFd() const
+        {
+            return notify_fd_;
+        }
+
+        // 设置没有inotify监控的文件以及不缓存的路径检查修改时间的间隔，为0时每次获取都检查
+        void setCheckInterval(uint64_t interval_ms)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            check_interval_ms_ = interval_ms;
+        }
+
+        // 移除所有缓存
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            while (!entries_.empty())
+                erase(entries_.begin());
+            uncached_.clear();
+            uncached_order_.clear();
+        }
+
+        size_t getTotalBytes()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return total_bytes_;
+        }
+
+        size_t getFileCount()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return entries_.size();
+        }
+
+        uint64_t getHits() const
+        {
+            return hits_.load(std::memory_order_relaxed);
+        }
+
+        uint64_t getMisses() const
+        {
+            return misses_.load(std::memory_order_relaxed);
+        }
+
+        // 记录的不缓存路径数
+        size_t getUncachedCount()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return uncached_.size();
+        }
+
+        // 直接根据记录返回不缓存原因的次数，这些获取没有打开文件
+        uint64_t getUncachedHits() const
+        {
+            return uncached_hits_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct Entry
+        {
+            CachedFile::ptr file;                  // 缓存的文件
+            std::list<std::string>::iterator lru_pos; // 在淘汰链表中的位置
+            int wd;                                // inotify监控描述符，没有监控时为-1
+            uint64_t checked_ms;                   // 上一次检查修改时间的时间
+        };
+
+        // 不缓存的路径，记录读取时的文件状态，文件状态变化之后重新读取
+        struct UncachedEntry
+        {
+            UncachedReason reason = UncachedReason::Unknown;
+            bool exists = false;                       // 路径是否存在
+            size_t size = 0;
+            struct timespec mtime = {0, 0};
+            ino_t inode = 0;
+            uint64_t checked_ms = 0;                   // 上一次检查文件状态的时间
+            std::list<std::string>::iterator order_pos; // 在记录顺序链表中的位置
+        };
+
+        static uint64_t getCurrentMs()
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        static bool isSameFile(size_t size, const struct timespec &mtime, ino_t inode, const struct stat &st)
+        {
+            return size == static_cast<size_t>(st.st_size) && inode == st.st_ino &&
+                   mtime.tv_sec == st.st_mtim.tv_sec && mtime.tv_nsec == st.st_mtim.tv_nsec;
+        }
+
+        static bool isSameFile(const CachedFile &file, const struct stat &st)
+        {
+            return isSameFile(file.size, file.mtime, file.inode, st);
+        }
+
+        // 判断缓存是否仍然有效，有inotify监控的文件变化时已经被移除，一定有效
+        bool isFresh(Entry &entry)
+        {
+            if (entry.wd >= 0)
+                return true;
+
+            uint64_t now = getCurrentMs();
+            if (now - entry.checked_ms < check_interval_ms_)
+                return true;
+
+            struct stat st;
+            if (::stat(entry.lru_pos->c_str(), &st) < 0 || !isSameFile(*entry.file, st))
+                return false;
+            entry.checked_ms = now;
+
+            return true;
+        }
+
+        // 判断不缓存的记录是否仍然有效，检查间隔内不访问文件系统，之后只检查文件状态是否变化
+        bool isStillUncached(const std::string &path, UncachedEntry &entry)
+        {
+            uint64_t now = getCurrentMs();
+            if (now - entry.checked_ms < check_interval_ms_)
+                return true;
+
+            struct stat st;
+            bool exists = ::stat(path.c_str(), &st) == 0;
+            if (exists != entry.exists || (exists && !isSameFile(entry.size, entry.mtime, entry.inode, st)))
+                return false;
+            entry.checked_ms = now;
+
+            return true;
+        }
+
+        // 读取文件并生成缓存，失败时在uncached中记录原因以及文件状态
+        CachedFile::ptr load(const std::string &path, const std::string &content_type, UncachedEntry &uncached)
+        {
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                // 只记录确定不存在的路径，权限等其他错误每次重新尝试
+                if (errno == ENOENT || errno == ENOTDIR)
+                    uncached.reason = UncachedReason::NotRegular;
+                return nullptr;
+            }
+
+            struct stat st;
+            if (::fstat(fd, &st) < 0)
+            {
+                ::close(fd);
+                return nullptr;
+            }
+            if (!S_ISREG(st.st_mode) || static_cast<size_t>(st.st_size) > max_file_size_)
+            {
+                ::close(fd);
+                uncached.reason = S_ISREG(st.st_mode) ? UncachedReason::TooLarge : UncachedReason::NotRegular;
+                uncached.exists = true;
+                uncached.size = st.st_size;
+                uncached.mtime = st.st_mtim;
+                uncached.inode = st.st_ino;
+                return nullptr;
+            }
+
+            std::string body(st.st_size, '\0');
+            size_t read_size = 0;
+            while (read_size < body.size())
+            {
+                ssize_t n = ::read(fd, &body[read_size], body.size() - read_size);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    break;
+                read_size += n;
+            }
+            ::close(fd);
+            // 读取期间文件被截断，不缓存
+            if (read_size != body.size())
+                return nullptr;
+
+            auto file = std::make_shared<CachedFile>();
+            file->size = body.size();
+            file->mtime = st.st_mtim;
+            file->inode = st.st_ino;
+            file->headers = std::make_shared<const std::string>("Content-Type: " + content_type + "\r\nContent-Length: " + std::to_string(body.size()) + "\r\n");
+            file->body = std::make_shared<const std::string>(std::move(body));
+
+            return file;
+        }
+
+        void insert(const std::string &path, const CachedFile::ptr &file)
+        {
+            int wd = notify_fd_ >= 0 ? inotify_add_watch(notify_fd_, path.c_str(), notify_mask) : -1;
+            // 读取文件之后、添加监控之前的变化不会产生事件，再次确认文件没有变化
+            struct stat st;
+            if (::stat(path.c_str(), &st) < 0 || !isSameFile(*file, st))
+            {
+                if (wd >= 0 && watches_.find(wd) == watches_.end())
+                    inotify_rm_watch(notify_fd_, wd);
+                return;
+            }
+
+            // 淘汰最近最少使用的文件直到有足够空间
+            while (!lru_.empty() && total_bytes_ + file->size > capacity_)
+                erase(entries_.find(lru_.back()));
+
+            lru_.push_front(path);
+            entries_.emplace(path, Entry{file, lru_.begin(), wd, getCurrentMs()});
+            if (wd >= 0)
+                watches_[wd].push_back(path);
+            total_bytes_ += file->size;
+        }
+
+        void erase(std::unordered_map<std::string, Entry>::iterator pos)
+        {
+            Entry &entry = pos->second;
+            if (entry.wd >= 0)
+            {
+                // 同一个文件可能通过不同路径缓存，共享同一个监控
+                auto watch = watches_.find(entry.wd);
+                if (watch != watches_.end())
+                {
+                    auto &paths = watch->second;
+                    paths.erase(std::remove(paths.begin(), paths.end(), pos->first), paths.end());
+                    if (paths.empty())
+                    {
+                        inotify_rm_watch(notify_fd_, entry.wd);
+                        watches_.erase(watch);
+                    }
+                }
+            }
+            total_bytes_ -= entry.file->size;
+            lru_.erase(entry.lru_pos);
+            entries_.erase(pos);
+        }
+
+        // 记录不缓存的路径，超过上限时移除最早的记录
+        void insertUncached(const std::string &path, UncachedEntry entry)
+        {
+            auto pos = uncached_.find(path);
+            if (pos != uncached_.end())
+                eraseUncached(pos);
+            while (!uncached_order_.empty() && uncached_.size() >= max_uncached_entries_)
+                eraseUncached(uncached_.find(uncached_order_.front()));
+
+            uncached_order_.push_back(path);
+            entry.order_pos = std::prev(uncached_order_.end());
+            entry.checked_ms = getCurrentMs();
+            uncached_.emplace(path, entry);
+        }
+
+        void eraseUncached(std::unordered_map<std::string, UncachedEntry>::iterator pos)
+        {
+            uncached_order_.erase(pos->second.order_pos);
+            uncached_.erase(pos);
+        }
+
+        // 移除监控描述符对应的所有缓存，removed表示监控已经被内核移除
+        void invalidate(int wd, bool removed)
+        {
+            auto watch = watches_.find(wd);
+            if (watch == watches_.end())
+                return;
+
+            std::vector<std::string> paths = std::move(watch->second);
+            watches_.erase(watch);
+            if (!removed)
+                inotify_rm_watch(notify_fd_, wd);
+            for (auto &path : paths)
+            {
+                auto pos = entries_.find(path);
+                if (pos == entries_.end())
+                    continue;
+                // 监控已经移除，避免erase再次处理
+                pos->second.wd = -1;
+                erase(pos);
+            }
+        }
+
+    private:
+        size_t capacity_;                                         // 缓存文件内容的总大小上限
+        size_t max_file_size_;                                    // 单个文件大小上限
+        size_t total_bytes_;                                      // 缓存文件内容的总大小
+        uint64_t check_interval_ms_;                              // 检查修改时间的间隔
+        size_t max_uncached_entries_;                             // 记录不缓存原因的路径数上限
+        int notify_fd_;                                           // inotify文件描述符
+        std::mutex mutex_;                                        // 保护下方所有结构
+        std::list<std::string> lru_;                              // 淘汰链表，头部为最近使用的文件
+        std::unordered_map<std::string, Entry> entries_;          // 文件路径与缓存的映射
+        std::unordered_map<int, std::vector<std::string>> watches_; // 监控描述符与文件路径的映射
+        std::list<std::string> uncached_order_;                   // 不缓存路径的记录顺序，头部为最早的记录
+        std::unordered_map<std::string, UncachedEntry> uncached_; // 不缓存的路径与原因的映射
+        std::atomic<uint64_t> hits_;                              // 命中次数
+        std::atomic<uint64_t> misses_;                            // 未命中次数
+        std::atomic<uint64_t> uncached_hits_;                     // 直接根据记录返回不缓存原因的次数
+    };
+}
+
+#endif
@@ -3,6 +3,8 @@
 
 #include <fstream>
 #include <filesystem>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <reactor_server/base/log.h>
 
 namespace rs_file_op
@@ -39,6 +41,35 @@ namespace rs_file_op
             return true;
         }
 
+        // 以只读方式打开文件，失败返回-1
+        static int openFile(const std::filesystem::path &filepath)
+        {
+            int fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                LOG(Level::Warning, "文件：{}打开失败", filepath.filename().string());
+
+            return fd;
+        }
+
+        // 获取文件大小，文件不存在时返回0
+        static size_t getFileSize(const std::filesystem::path &filepath)
+        {
+            std::error_code ec;
+            size_t size = std::filesystem::file_size(filepath, ec);
+            return ec ? 0 : size;
+        }
+
+        // 获取已经打开的普通文件的大小，不是普通文件或者获取失败时返回假
+        static bool getFileSize(int fd, size_t &size)
+        {
+            struct stat st;
+            if (::fstat(fd, &st) < 0 || !S_ISREG(st.st_mode))
+                return false;
+            size = st.st_size;
+
+            return true;
+        }
+
         // 写入文件
         static bool writeFile(const std::filesystem::path &filepath, const std::string &in_buf)
         {
@@ -1,6 +1,7 @@
 #ifndef __rs_info_get_h__
 #define __rs_info_get_h__
 
+#include <array>
 #include <string>
 #include <unordered_map>
 
@@ -158,6 +159,27 @@ namespace rs_info_get
             return pos->second;
         }
 
+        // 获取状态码对应的状态行（不包括前面的协议版本），例如" 200 OK\r\n"
+        // 100到599的状态行在第一次调用时全部生成，之后直接返回
+        static const std::string &getStatusLine(int code)
+        {
+            static const std::array<std::string, 600> lines = []()
+            {
+                std::array<std::string, 600> l;
+                for (int i = 100; i < 600; i++)
+                    l[i] = " " + std::to_string(i) + " " + getStatusDesc(i) + "\r\n";
+                return l;
+            }();
+
+            if (code >= 100 && code < 600)
+                return lines[code];
+
+            // 不合法的状态码不缓存
+            thread_local std::string line;
+            line = " " + std::to_string(code) + " " + getStatusDesc(code) + "\r\n";
+            return line;
+        }
+
         // 获取MIME类型
         static std::string getMimeType(const std::string &type)
         {
@@ -2,6 +2,7 @@
 #define __rs_url_op_h__
 
 #include <string>
+#include <string_view>
 #include <cctype>
 
 namespace rs_url_op
@@ -41,7 +42,7 @@ namespace rs_url_op
         }
 
         // 对URL进行解码
-        static bool urlDecode(std::string &out, const std::string &in, bool convert_space = false)
+        static bool urlDecode(std::string &out, std::string_view in, bool convert_space = false)
         {
             if (in.size() == 0)
                 return false;
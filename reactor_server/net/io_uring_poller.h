@@ -0,0 +1,608 @@
+#ifndef __rs_io_uring_poller_h__
+#define __rs_io_uring_poller_h__
+
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/utsname.h>
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include <reactor_server/base/log.h>
+#include <reactor_server/base/error.h>
+#include <reactor_server/net/channel.h>
+
+namespace rs_io_uring_poller
+{
+    using namespace rs_log_system;
+
+    // 提交队列大小，完成队列大小由内核设置为提交队列的两倍
+    const unsigned uring_entries = 1024;
+
+    // 移除poll请求的完成事件不需要处理，使用该值作为用户数据
+    const uint64_t remove_user_data = UINT64_MAX;
+
+    // 提供给接收请求的缓冲区个数与大小，个数必须为2的幂
+    const unsigned uring_buffer_count = 512;
+    const unsigned uring_buffer_size = 4096;
+    const uint16_t uring_buffer_group = 0;
+
+    // 用户数据低32位中的标记位，其余位为注册项下标
+    const uint32_t data_request_flag = 1u << 30;   // 获取连接/接收请求
+    const uint32_t accept_request_flag = 1u << 31; // 获取连接请求
+    const uint32_t slot_index_mask = data_request_flag - 1;
+
+    /**
+     * 基于io_uring的事件监控，使用poll请求得到与epoll一致的就绪通知，Channel的回调语义保持不变
+     * 水平触发的Channel使用单次poll请求，事件处理之后重新提交，提交时内核会立即检查一次就绪状态
+     * 边缘触发的Channel使用多次触发的poll请求，只有内核结束该请求时才重新提交
+     * 设置了完成方式的Channel的可读事件不使用poll请求，而是提交多次触发的获取连接/接收请求，
+     * 完成结果保存在Channel中并以可读事件通知，接收的数据位于注册给内核的缓冲区环中，下一次等待时归还
+     * 事件关心的变化只写入提交队列，在下一次等待时与等待一起通过一次io_uring_enter提交
+     */
+    class IoUringPoller
+    {
+    public:
+        using ptr = std::shared_ptr<IoUringPoller>;
+
+        IoUringPoller()
+            : ring_fd_(-1), ring_ptr_(MAP_FAILED), ring_size_(0), sqes_(static_cast<struct io_uring_sqe *>(MAP_FAILED)), sqes_size_(0), sq_tail_local_(0),
+              buf_ring_(static_cast<struct io_uring_buf_ring *>(MAP_FAILED)), buffers_(static_cast<char *>(MAP_FAILED)), buf_tail_local_(0), completion_enabled_(false)
+        {
+        }
+
+        // 创建io_uring并映射队列，内核不支持时返回false
+        bool init()
+        {
+            struct io_uring_params params;
+            memset(&params, 0, sizeof(params));
+            ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, uring_entries, &params));
+            if (ring_fd_ < 0)
+            {
+                LOG(Level::Warning, "创建io_uring失败：{}", strerror(errno));
+                return false;
+            }
+
+            // 多次触发的poll请求从内核5.13开始支持，使用同一版本引入的特性判断
+            uint32_t required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_RSRC_TAGS;
+            if ((params.features & required) != required)
+            {
+                LOG(Level::Warning, "内核io_uring版本过低");
+                return false;
+            }
+
+            // 提交队列与完成队列共享一次映射
+            size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+            ring_size_ = std::max(sq_size, cq_size);
+            ring_ptr_ = mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+            sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+            sqes_ = static_cast<struct io_uring_sqe *>(mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES));
+            if (ring_ptr_ == MAP_FAILED || sqes_ == MAP_FAILED)
+            {
+                LOG(Level::Warning, "映射io_uring队列失败：{}", strerror(errno));
+                return false;
+            }
+
+            char *base = static_cast<char *>(ring_ptr_);
+            sq_head_ = reinterpret_cast<unsigned *>(base + params.sq_off.head);
+            sq_tail_ = reinterpret_cast<unsigned *>(base + params.sq_off.tail);
+            sq_mask_ = *reinterpret_cast<unsigned *>(base + params.sq_off.ring_mask);
+            sq_entries_ = params.sq_entries;
+            cq_head_ = reinterpret_cast<unsigned *>(base + params.cq_off.head);
+            cq_tail_ = reinterpret_cast<unsigned *>(base + params.cq_off.tail);
+            cq_mask_ = *reinterpret_cast<unsigned *>(base + params.cq_off.ring_mask);
+            cqes_ = reinterpret_cast<struct io_uring_cqe *>(base + params.cq_off.cqes);
+            sq_tail_local_ = *sq_tail_;
+
+            // 提交队列的下标数组固定为一一对应，之后只需要填写请求并移动队尾
+            unsigned *sq_array = reinterpret_cast<unsigned *>(base + params.sq_off.array);
+            for (unsigned i = 0; i < sq_entries_; i++)
+                sq_array[i] = i;
+
+            completion_enabled_ = initBufferRing();
+            if (!completion_enabled_)
+                LOG(Level::Info, "io_uring不支持多次触发的接收请求，只使用poll请求");
+
+            return true;
+        }
+
+        // 是否支持以完成方式处理可读事件
+        bool isCompletionEnabled()
+        {
+            return completion_enabled_;
+        }
+
+        // 添加/更新指定描述符的事件监控，只记录变化，下一次等待时统一提交
+        void updateEvent(rs_channel::Channel *channel)
+        {
+            if (!channel->isInPoller())
+            {
+                channel->setPollSlot(allocSlot(channel));
+                channel->setInPoller(true);
+            }
+            channel->setAppliedEvents(channel->getEvents());
+
+            uint32_t index = channel->getPollSlot();
+            PollSlot &slot = slots_[index];
+            bool want_data = wantData(channel);
+            if (slot.data_armed && !want_data)
+                cancelData(index);
+            if (want_data && !slot.data_armed)
+                markDirty(index);
+
+            uint32_t events = getPollEvents(channel);
+            if (slot.armed && slot.armed_events == events)
+                return;
+            if (slot.armed)
+                cancel(index);
+            markDirty(index);
+        }
+
+        // 移除指定描述符的事件监控
+        void removeEvent(rs_channel::Channel *channel)
+        {
+            if (!channel->isInPoller())
+                return;
+
+            uint32_t index = channel->getPollSlot();
+            if (slots_[index].armed)
+                cancel(index);
+            if (slots_[index].data_armed)
+                cancelData(index);
+            // 修改序号使得已经在完成队列中的事件被忽略
+            slots_[index].channel = nullptr;
+            slots_[index].seq++;
+            slots_[index].data_seq++;
+            free_slots_.push_back(index);
+            channel->setInPoller(false);
+            channel->setAppliedEvents(0);
+
+            // 本轮就绪数组中可能还有尚未处理的该Channel，置空防止后续访问已经移除（可能已经释放）的Channel
+            std::replace(ready_channels_.begin(), ready_channels_.end(), channel, static_cast<rs_channel::Channel *>(nullptr));
+        }
+
+        // 提交本轮所有的请求，阻塞时等待至少一个完成事件，返回就绪数组
+        std::vector<rs_channel::Channel *> &startEpoll(bool block = true)
+        {
+            ready_channels_.clear();
+
+            // 上一轮的完成结果已经处理完毕，清空并归还其中的缓冲区
+            for (uint32_t index : completion_slots_)
+            {
+                slots_[index].has_completion = false;
+                if (slots_[index].channel)
+                    slots_[index].channel->getCompletions().clear();
+            }
+            completion_slots_.clear();
+            recycleBuffers();
+
+            armDirtySlots();
+            if (enter(IORING_ENTER_GETEVENTS, block ? 1 : 0) < 0)
+            {
+                if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+                {
+                    LOG(Level::Error, "io_uring等待失败：{}", strerror(errno));
+                    exit(static_cast<int>(rs_error::ErrorNum::IoUring_wait_fail));
+                }
+            }
+
+            reapCompletions();
+
+            return ready_channels_;
+        }
+
+        // 获取提交的poll请求变化次数，对应epoll后端的epoll_ctl调用次数
+        uint64_t getCtlCount()
+        {
+            return ctl_count_.load(std::memory_order_relaxed);
+        }
+
+        ~IoUringPoller()
+        {
+            if (buffers_ != MAP_FAILED)
+                munmap(buffers_, static_cast<size_t>(uring_buffer_count) * uring_buffer_size);
+            if (buf_ring_ != MAP_FAILED)
+                munmap(buf_ring_, uring_buffer_count * sizeof(struct io_uring_buf));
+            if (sqes_ != MAP_FAILED)
+                munmap(sqes_, sqes_size_);
+            if (ring_ptr_ != MAP_FAILED)
+                munmap(ring_ptr_, ring_size_);
+            if (ring_fd_ >= 0)
+                ::close(ring_fd_);
+        }
+
+    private:
+        // 每个Channel对应一个注册项，请求的用户数据由注册项下标和序号组成
+        // 每次提交或者取消请求时序号递增，过期请求的完成事件因为序号不一致而被忽略
+        struct PollSlot
+        {
+            rs_channel::Channel *channel = nullptr;
+            uint32_t seq = 0;          // 当前请求的序号
+            uint32_t armed_events = 0; // 已经提交的请求关心的事件
+            uint32_t revents = 0;      // 本轮收集到的就绪事件
+            bool armed = false;        // 是否有尚未结束的poll请求
+            bool dirty = false;        // 是否在待提交数组中
+            bool ready = false;        // 本轮是否已经就绪
+            uint32_t data_seq = 0;     // 当前获取连接/接收请求的序号
+            bool data_armed = false;   // 是否有尚未结束的获取连接/接收请求
+            bool data_done = false;    // 接收请求已经读到结束或者出错，不再提交
+            bool has_completion = false; // 本轮是否已经添加完成结果
+        };
+
+        static uint64_t makeUserData(uint32_t index, uint32_t seq)
+        {
+            return (static_cast<uint64_t>(seq) << 32) | index;
+        }
+
+        // 检查内核版本，多次触发的接收请求从内核6.0开始支持
+        static bool isKernelAtLeast(int major, int minor)
+        {
+            struct utsname name;
+            if (uname(&name) < 0)
+                return false;
+            int cur_major = 0, cur_minor = 0;
+            if (sscanf(name.release, "%d.%d", &cur_major, &cur_minor) != 2)
+                return false;
+
+            return cur_major > major || (cur_major == major && cur_minor >= minor);
+        }
+
+        // 注册接收请求使用的缓冲区环，失败时只使用poll请求
+        bool initBufferRing()
+        {
+            if (!isKernelAtLeast(6, 0))
+                return false;
+
+            size_t ring_size = uring_buffer_count * sizeof(struct io_uring_buf);
+            size_t buffers_size = static_cast<size_t>(uring_buffer_count) * uring_buffer_size;
+            buf_ring_ = static_cast<struct io_uring_buf_ring *>(mmap(nullptr, ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            buffers_ = static_cast<char *>(mmap(nullptr, buffers_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            if (buf_ring_ == MAP_FAILED || buffers_ == MAP_FAILED)
+                return false;
+
+            struct io_uring_buf_reg reg;
+            memset(&reg, 0, sizeof(reg));
+            reg.ring_addr = reinterpret_cast<uint64_t>(buf_ring_);
+            reg.ring_entries = uring_buffer_count;
+            reg.bgid = uring_buffer_group;
+            if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+                return false;
+
+            for (unsigned i = 0; i < uring_buffer_count; i++)
+                addBuffer(static_cast<uint16_t>(i));
+            __atomic_store_n(&buf_ring_->tail, buf_tail_local_, __ATOMIC_RELEASE);
+
+            return true;
+        }
+
+        // 将缓冲区放回缓冲区环，需要发布队尾之后内核才可见
+        void addBuffer(uint16_t bid)
+        {
+            // 头文件中的柔性数组在C++中会偏移8字节，直接按照缓冲区描述数组访问
+            struct io_uring_buf *bufs = reinterpret_cast<struct io_uring_buf *>(buf_ring_);
+            struct io_uring_buf &buf = bufs[buf_tail_local_ & (uring_buffer_count - 1)];
+            buf.addr = reinterpret_cast<uint64_t>(buffers_ + static_cast<size_t>(bid) * uring_buffer_size);
+            buf.len = uring_buffer_size;
+            buf.bid = bid;
+            buf_tail_local_++;
+        }
+
+        // 归还上一轮完成事件中使用的缓冲区
+        void recycleBuffers()
+        {
+            if (returned_buffers_.empty())
+                return;
+            for (uint16_t bid : returned_buffers_)
+                addBuffer(bid);
+            __atomic_store_n(&buf_ring_->tail, buf_tail_local_, __ATOMIC_RELEASE);
+            returned_buffers_.clear();
+        }
+
+        // 是否使用获取连接/接收请求处理可读事件
+        bool wantData(rs_channel::Channel *channel)
+        {
+            return completion_enabled_ && channel->getCompletionOp() != rs_channel::CompletionOp::None && (channel->getEvents() & EPOLLIN);
+        }
+
+        // poll请求关心的事件，可读事件由获取连接/接收请求处理时不包含可读事件
+        uint32_t getPollEvents(rs_channel::Channel *channel)
+        {
+            uint32_t events = channel->getEvents();
+            if (wantData(channel))
+                events &= ~EPOLLIN;
+
+            return events;
+        }
+
+        uint32_t allocSlot(rs_channel::Channel *channel)
+        {
+            uint32_t index = 0;
+            if (!free_slots_.empty())
+            {
+                index = free_slots_.back();
+                free_slots_.pop_back();
+            }
+            else
+            {
+                index = static_cast<uint32_t>(slots_.size());
+                slots_.emplace_back();
+            }
+            slots_[index].channel = channel;
+            slots_[index].armed = false;
+            slots_[index].data_armed = false;
+            slots_[index].data_done = false;
+
+            return index;
+        }
+
+        void markDirty(uint32_t index)
+        {
+            if (slots_[index].dirty)
+                return;
+            slots_[index].dirty = true;
+            dirty_slots_.push_back(index);
+        }
+
+        // 为所有需要重新提交的Channel提交poll请求
+        void armDirtySlots()
+        {
+            for (uint32_t index : dirty_slots_)
+            {
+                PollSlot &slot = slots_[index];
+                slot.dirty = false;
+                if (!slot.channel)
+                    continue;
+                if (!slot.armed && (getPollEvents(slot.channel) & ~EPOLLET) != 0)
+                    arm(index);
+                if (!slot.data_armed && !slot.data_done && wantData(slot.channel))
+                    armData(index);
+            }
+            dirty_slots_.clear();
+        }
+
+        void arm(uint32_t index)
+        {
+            PollSlot &slot = slots_[index];
+            uint32_t events = getPollEvents(slot.channel);
+            slot.seq++;
+            slot.armed = true;
+            slot.armed_events = events;
+
+            struct io_uring_sqe *sqe = getSqe();
+            sqe->opcode = IORING_OP_POLL_ADD;
+            sqe->fd = slot.channel->getFd();
+            sqe->poll32_events = events & ~EPOLLET;
+            // 边缘触发模式使用多次触发的请求，每次有新的唤醒时产生完成事件
+            if (events & EPOLLET)
+                sqe->len = IORING_POLL_ADD_MULTI;
+            sqe->user_data = makeUserData(index, slot.seq);
+        }
+
+        void cancel(uint32_t index)
+        {
+            PollSlot &slot = slots_[index];
+            struct io_uring_sqe *sqe = getSqe();
+            sqe->opcode = IORING_OP_POLL_REMOVE;
+            sqe->fd = -1;
+            sqe->addr = makeUserData(index, slot.seq);
+            sqe->user_data = remove_user_data;
+            slot.seq++;
+            slot.armed = false;
+        }
+
+        // 提交多次触发的获取连接/接收请求，内核结束请求之前每个新连接/每段数据产生一个完成事件
+        void armData(uint32_t index)
+        {
+            PollSlot &slot = slots_[index];
+            slot.data_seq++;
+            slot.data_armed = true;
+
+            struct io_uring_sqe *sqe = getSqe();
+            sqe->fd = slot.channel->getFd();
+            uint32_t flags = data_request_flag;
+            if (slot.channel->getCompletionOp() == rs_channel::CompletionOp::Accept)
+            {
+                sqe->opcode = IORING_OP_ACCEPT;
+                sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+                sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+                flags |= accept_request_flag;
+            }
+            else
+            {
+                // 长度为0时使用缓冲区环中缓冲区的完整大小
+                sqe->opcode = IORING_OP_RECV;
+                sqe->ioprio = IORING_RECV_MULTISHOT;
+                sqe->flags = IOSQE_BUFFER_SELECT;
+                sqe->buf_group = uring_buffer_group;
+            }
+            sqe->user_data = makeUserData(index | flags, slot.data_seq);
+        }
+
+        void cancelData(uint32_t index)
+        {
+            PollSlot &slot = slots_[index];
+            uint32_t flags = data_request_flag;
+            if (slot.channel && slot.channel->getCompletionOp() == rs_channel::CompletionOp::Accept)
+                flags |= accept_request_flag;
+            struct io_uring_sqe *sqe = getSqe();
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = -1;
+            sqe->addr = makeUserData(index | flags, slot.data_seq);
+            sqe->user_data = remove_user_data;
+            slot.data_seq++;
+            slot.data_armed = false;
+        }
+
+        // 获取一个空闲的提交队列项，提交队列已满时先提交已有的请求
+        struct io_uring_sqe *getSqe()
+        {
+            if (sq_tail_local_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_)
+            {
+                enter(0, 0);
+                if (sq_tail_local_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_)
+                {
+                    LOG(Level::Error, "io_uring提交失败：{}", strerror(errno));
+                    exit(static_cast<int>(rs_error::ErrorNum::IoUring_submit_fail));
+                }
+            }
+
+            struct io_uring_sqe *sqe = &sqes_[sq_tail_local_ & sq_mask_];
+            memset(sqe, 0, sizeof(*sqe));
+            sq_tail_local_++;
+            ctl_count_.fetch_add(1, std::memory_order_relaxed);
+
+            return sqe;
+        }
+
+        // 发布队尾并提交所有尚未被内核取走的请求
+        int enter(unsigned flags, unsigned min_complete)
+        {
+            __atomic_store_n(sq_tail_, sq_tail_local_, __ATOMIC_RELEASE);
+            unsigned to_submit = sq_tail_local_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+
+            return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, flags, nullptr, 0));
+        }
+
+        // 取出所有完成事件，同一Channel的多个完成事件合并为一次就绪
+        void reapCompletions()
+        {
+            unsigned head = *cq_head_;
+            unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            for (; head != tail; head++)
+            {
+                struct io_uring_cqe &cqe = cqes_[head & cq_mask_];
+                handleCompletion(cqe.user_data, cqe.res, cqe.flags);
+            }
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+            for (uint32_t index : ready_slots_)
+            {
+                PollSlot &slot = slots_[index];
+                slot.ready = false;
+                slot.channel->setReadyEvents(slot.revents);
+                ready_channels_.push_back(slot.channel);
+            }
+            ready_slots_.clear();
+        }
+
+        void handleCompletion(uint64_t user_data, int32_t res, uint32_t flags)
+        {
+            // 无论完成事件是否过期，内核选用的缓冲区都需要归还
+            if (flags & IORING_CQE_F_BUFFER)
+                returned_buffers_.push_back(static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT));
+            if (user_data == remove_user_data)
+                return;
+
+            uint32_t index = static_cast<uint32_t>(user_data);
+            uint32_t seq = static_cast<uint32_t>(user_data >> 32);
+            if (index & data_request_flag)
+            {
+                handleDataCompletion(index, seq, res, flags);
+                return;
+            }
+            if (index >= slots_.size())
+                return;
+            PollSlot &slot = slots_[index];
+            if (!slot.channel || slot.seq != seq)
+                return;
+
+            // 请求已经结束，事件处理之后重新提交
+            if (!(flags & IORING_CQE_F_MORE))
+            {
+                slot.armed = false;
+                markDirty(index);
+            }
+
+            uint32_t revents = res < 0 ? EPOLLERR : static_cast<uint32_t>(res);
+            if (!slot.ready)
+            {
+                slot.ready = true;
+                slot.revents = 0;
+                ready_slots_.push_back(index);
+            }
+            slot.revents |= revents;
+        }
+
+        void handleDataCompletion(uint32_t tagged_index, uint32_t seq, int32_t res, uint32_t flags)
+        {
+            bool accept = tagged_index & accept_request_flag;
+            uint32_t index = tagged_index & slot_index_mask;
+            if (index >= slots_.size() || !slots_[index].channel || slots_[index].data_seq != seq)
+            {
+                // 已经取消的获取连接请求仍可能得到新连接，直接关闭
+                if (accept && res >= 0)
+                    ::close(res);
+                return;
+            }
+
+            PollSlot &slot = slots_[index];
+            if (!(flags & IORING_CQE_F_MORE))
+            {
+                // 请求已经结束，获取连接请求与正常接收数据时下一轮重新提交
+                // 缓冲区耗尽时没有数据，只需要重新提交
+                slot.data_armed = false;
+                if (accept || res > 0 || res == -ENOBUFS)
+                    markDirty(index);
+                else
+                    slot.data_done = true;
+            }
+            if (res == -ENOBUFS)
+                return;
+
+            const char *data = nullptr;
+            if (res > 0 && (flags & IORING_CQE_F_BUFFER))
+                data = buffers_ + static_cast<size_t>(flags >> IORING_CQE_BUFFER_SHIFT) * uring_buffer_size;
+            if (!slot.has_completion)
+            {
+                slot.has_completion = true;
+                completion_slots_.push_back(index);
+            }
+            slot.channel->addCompletion(res, data);
+
+            if (!slot.ready)
+            {
+                slot.ready = true;
+                slot.revents = 0;
+                ready_slots_.push_back(index);
+            }
+            slot.revents |= EPOLLIN;
+        }
+
+    private:
+        int ring_fd_;                // io_uring文件描述符
+        void *ring_ptr_;             // 提交队列与完成队列的映射地址
+        size_t ring_size_;           // 队列映射大小
+        struct io_uring_sqe *sqes_;  // 提交队列项数组
+        size_t sqes_size_;           // 提交队列项数组映射大小
+        unsigned *sq_head_;          // 提交队列队头，由内核修改
+        unsigned *sq_tail_;          // 提交队列队尾
+        unsigned sq_mask_;           // 提交队列下标掩码
+        unsigned sq_entries_;        // 提交队列大小
+        unsigned sq_tail_local_;     // 尚未发布的提交队列队尾
+        unsigned *cq_head_;          // 完成队列队头
+        unsigned *cq_tail_;          // 完成队列队尾，由内核修改
+        unsigned cq_mask_;           // 完成队列下标掩码
+        struct io_uring_cqe *cqes_;  // 完成队列项数组
+        struct io_uring_buf_ring *buf_ring_; // 接收请求使用的缓冲区环
+        char *buffers_;              // 缓冲区环中的缓冲区
+        uint16_t buf_tail_local_;    // 尚未发布的缓冲区环队尾
+        bool completion_enabled_;    // 是否支持以完成方式处理可读事件
+
+        std::vector<PollSlot> slots_;                      // 所有Channel的注册项
+        std::vector<uint32_t> free_slots_;                 // 空闲的注册项下标
+        std::vector<uint32_t> dirty_slots_;                // 下一次等待之前需要重新提交请求的注册项
+        std::vector<uint32_t> ready_slots_;                // 本轮就绪的注册项
+        std::vector<uint32_t> completion_slots_;           // 本轮添加了完成结果的注册项
+        std::vector<uint16_t> returned_buffers_;           // 下一轮需要归还的缓冲区
+        std::vector<rs_channel::Channel *> ready_channels_; // 本轮就绪的事件监控结构
+        std::atomic<uint64_t> ctl_count_{0};               // 提交的poll请求变化次数
+    };
+}
+
+#endif
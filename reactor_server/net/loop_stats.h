@@ -0,0 +1,187 @@
+#ifndef __rs_loop_stats_h__
+#define __rs_loop_stats_h__
+
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace rs_loop_stats
+{
+    // 直方图每个2的幂区间划分的子区间位数，8个子区间时相对误差不超过12.5%
+    const int histogram_sub_bits = 3;
+    const uint64_t histogram_sub_count = 1 << histogram_sub_bits;
+    // 记录值的上限，超过时按上限记录
+    const uint64_t histogram_max_value = UINT32_MAX;
+    // 覆盖0到histogram_max_value需要的区间个数
+    const size_t histogram_buckets = (32 - histogram_sub_bits + 1) * histogram_sub_count;
+
+    // 直方图快照，可以在任意线程中使用
+    struct HistogramSnapshot
+    {
+        std::array<uint64_t, histogram_buckets> counts{}; // 每个区间的记录个数
+        uint64_t count = 0;                                // 记录总数
+        uint64_t sum = 0;                                  // 记录值之和
+        uint64_t max = 0;                                  // 最大记录值
+
+        double getMean() const
+        {
+            return count == 0 ? 0 : static_cast<double>(sum) / count;
+        }
+
+        // 获取百分位数（0到100），返回所在区间的上界，不超过最大记录值
+        uint64_t getPercentile(double percentile) const;
+    };
+
+    /**
+     * HDR风格的对数线性直方图，区间宽度随数值按2的幂增长，相对误差固定
+     * 只能由单个线程记录，快照可以在任意线程中获取，快照中的各个字段不保证严格一致
+     */
+    class Histogram
+    {
+    public:
+        Histogram()
+        {
+            for (auto &count : counts_)
+                count.store(0, std::memory_order_relaxed);
+        }
+
+        // 记录一个值，只能在单个线程中调用
+        void record(uint64_t value)
+        {
+            if (value > histogram_max_value)
+                value = histogram_max_value;
+            increase(counts_[getIndex(value)], 1);
+            increase(sum_, value);
+            if (value > max_.load(std::memory_order_relaxed))
+                max_.store(value, std::memory_order_relaxed);
+        }
+
+        HistogramSnapshot snapshot() const
+        {
+            HistogramSnapshot snap;
+            for (size_t i = 0; i < histogram_buckets; i++)
+            {
+                snap.counts[i] = counts_[i].load(std::memory_order_relaxed);
+                snap.count += snap.counts[i];
+            }
+            snap.sum = sum_.load(std::memory_order_relaxed);
+            snap.max = max_.load(std::memory_order_relaxed);
+
+            return snap;
+        }
+
+        // 获取值所在区间的下标
+        static size_t getIndex(uint64_t value)
+        {
+            if (value < histogram_sub_count)
+                return value;
+            int msb = 63 - __builtin_clzll(value);
+            int shift = msb - histogram_sub_bits;
+            return (shift + 1) * histogram_sub_count + ((value >> shift) & (histogram_sub_count - 1));
+        }
+
+        // 获取区间能够记录的最大值
+        static uint64_t getUpperBound(size_t index)
+        {
+            if (index < histogram_sub_count)
+                return index;
+            int shift = index / histogram_sub_count - 1;
+            uint64_t lower = (histogram_sub_count + index % histogram_sub_count) << shift;
+            return lower + (1ull << shift) - 1;
+        }
+
+    private:
+        // 单个线程写入，不需要原子的读改写
+        static void increase(std::atomic<uint64_t> &counter, uint64_t delta)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+
+    private:
+        std::array<std::atomic<uint64_t>, histogram_buckets> counts_; // 每个区间的记录个数
+        std::atomic<uint64_t> sum_{0};                                 // 记录值之和
+        std::atomic<uint64_t> max_{0};                                 // 最大记录值
+    };
+
+    inline uint64_t HistogramSnapshot::getPercentile(double percentile) const
+    {
+        if (count == 0)
+            return 0;
+        uint64_t target = static_cast<uint64_t>(percentile / 100 * count);
+        if (target == 0)
+            target = 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < histogram_buckets; i++)
+        {
+            seen += counts[i];
+            if (seen >= target)
+                return std::min(Histogram::getUpperBound(i), max);
+        }
+
+        return max;
+    }
+
+    // 事件循环统计快照，时间单位均为微秒
+    struct LoopStatsSnapshot
+    {
+        uint64_t iterations = 0;            // 事件循环轮数
+        uint64_t wait_us = 0;               // 等待事件的累计耗时
+        uint64_t event_us = 0;              // 处理就绪事件的累计耗时
+        uint64_t task_us = 0;               // 执行任务队列的累计耗时
+        HistogramSnapshot iteration_us;     // 每轮事件处理与任务执行耗时
+        HistogramSnapshot task_delay_us;    // 任务从唤醒事件循环到开始执行的延迟
+        HistogramSnapshot ready_events;     // 每次唤醒就绪的事件个数
+        HistogramSnapshot tasks_per_drain;  // 每次从任务队列取出执行的任务个数
+    };
+
+    // 事件循环统计，只由事件循环线程写入
+    class LoopStats
+    {
+    public:
+        // 记录一轮事件循环，wait_begin为上一轮结束的时间，events_end为就绪事件处理完毕的时间
+        void recordIteration(uint64_t wait_begin, uint64_t begin, uint64_t events_end, uint64_t end, size_t ready)
+        {
+            iterations_.store(iterations_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            wait_us_.store(wait_us_.load(std::memory_order_relaxed) + (begin - wait_begin), std::memory_order_relaxed);
+            event_us_.store(event_us_.load(std::memory_order_relaxed) + (events_end - begin), std::memory_order_relaxed);
+            task_us_.store(task_us_.load(std::memory_order_relaxed) + (end - events_end), std::memory_order_relaxed);
+            iteration_us_.record(end - begin);
+            ready_events_.record(ready);
+        }
+
+        // 记录一次任务队列的执行
+        void recordDrain(uint64_t delay_us, size_t tasks)
+        {
+            task_delay_us_.record(delay_us);
+            tasks_per_drain_.record(tasks);
+        }
+
+        LoopStatsSnapshot snapshot() const
+        {
+            LoopStatsSnapshot snap;
+            snap.iterations = iterations_.load(std::memory_order_relaxed);
+            snap.wait_us = wait_us_.load(std::memory_order_relaxed);
+            snap.event_us = event_us_.load(std::memory_order_relaxed);
+            snap.task_us = task_us_.load(std::memory_order_relaxed);
+            snap.iteration_us = iteration_us_.snapshot();
+            snap.task_delay_us = task_delay_us_.snapshot();
+            snap.ready_events = ready_events_.snapshot();
+            snap.tasks_per_drain = tasks_per_drain_.snapshot();
+
+            return snap;
+        }
+
+    private:
+        std::atomic<uint64_t> iterations_{0};
+        std::atomic<uint64_t> wait_us_{0};
+        std::atomic<uint64_t> event_us_{0};
+        std::atomic<uint64_t> task_us_{0};
+        Histogram iteration_us_;
+        Histogram task_delay_us_;
+        Histogram ready_events_;
+        Histogram tasks_per_drain_;
+    };
+}
+
+#endif
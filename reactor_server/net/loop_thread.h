@@ -13,8 +13,8 @@ namespace rs_loop_thread
     public:
         using ptr = std::shared_ptr<LoopThread>;
 
-        LoopThread()
-            : thread_(std::thread(std::bind(&LoopThread::threadEntry, this))), loop_(nullptr)
+        LoopThread(rs_event_loop_lock_queue::TaskQueueType type = rs_event_loop_lock_queue::TaskQueueType::Locked, rs_poller::PollerType poller_type = rs_poller::PollerType::Epoll)
+            : task_queue_type_(type), poller_type_(poller_type), loop_(nullptr), thread_(std::thread(std::bind(&LoopThread::threadEntry, this)))
         {
 
         }
@@ -37,7 +37,7 @@ namespace rs_loop_thread
         void threadEntry()
         {
             // 实例化EventLoop对象，再启动事件监控
-            rs_event_loop_lock_queue::EventLoopLockQueue::ptr loop = std::make_shared<rs_event_loop_lock_queue::EventLoopLockQueue>();
+            rs_event_loop_lock_queue::EventLoopLockQueue::ptr loop = std::make_shared<rs_event_loop_lock_queue::EventLoopLockQueue>(task_queue_type_, poller_type_);
             {
                 std::unique_lock<std::mutex> lock(loop_mtx_);
                 loop_ = loop;
@@ -50,8 +50,11 @@ namespace rs_loop_thread
     private:
         std::mutex loop_mtx_;
         std::condition_variable loop_con_;
-        std::thread thread_;
+        rs_event_loop_lock_queue::TaskQueueType task_queue_type_;
+        rs_poller::PollerType poller_type_;
+        // 线程必须在其余成员初始化完成之后再启动，防止线程中设置的loop_被构造函数覆盖
         rs_event_loop_lock_queue::EventLoopLockQueue::ptr loop_;
+        std::thread thread_;
     };
 }
 
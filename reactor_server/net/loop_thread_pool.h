@@ -1,17 +1,34 @@
 #ifndef __rs_loop_thread_pool_h__
 #define __rs_loop_thread_pool_h__
 
+#include <map>
+#include <string>
+#include <sys/socket.h>
+#include <netinet/in.h>
 #include <reactor_server/net/loop_thread.h>
 
 namespace rs_loop_thread_pool
 {
+    // 新连接分配从属事件循环的策略
+    enum class LoadBalancePolicy
+    {
+        RoundRobin,        // 轮询
+        LeastConnections,  // 连接数最少
+        LeastPendingBytes, // 输出缓冲区待发送数据量最少
+        LeastLoopLag,      // 事件循环延迟最小
+        ConsistentHash     // 按照对端地址一致性哈希，同一客户端地址总是分配到同一事件循环
+    };
+
+    // 一致性哈希中每个事件循环的虚拟节点个数
+    const int hash_virtual_nodes = 160;
+
     class LoopThreadPool
     {
     public:
         using ptr = std::shared_ptr<LoopThreadPool>;
 
         LoopThreadPool(rs_event_loop_lock_queue::EventLoopLockQueue* loop)
-            : base_loop_(loop), thread_num_(0), next_loop_(0)
+            : base_loop_(loop), thread_num_(0), next_loop_(0), task_queue_type_(rs_event_loop_lock_queue::TaskQueueType::Locked), poller_type_(rs_poller::PollerType::Epoll), policy_(LoadBalancePolicy::RoundRobin)
         {
         }
 
@@ -26,9 +43,11 @@ namespace rs_loop_thread_pool
                 // 创建从属线程
                 for (int i = 0; i < thread_num_; i++)
                 {
-                    loop_threads_[i] = std::make_shared<rs_loop_thread::LoopThread>();
+                    loop_threads_[i] = std::make_shared<rs_loop_thread::LoopThread>(task_queue_type_, poller_type_);
                     loops_[i] = loop_threads_[i]->getLoop();
                 }
+                if (policy_ == LoadBalancePolicy::ConsistentHash)
+                    createHashRing();
             }
         }
 
@@ -37,19 +56,160 @@ namespace rs_loop_thread_pool
             thread_num_ = num;
         }
 
-        rs_event_loop_lock_queue::EventLoopLockQueue* getNextLoop()
+        // 设置从属事件循环的任务队列实现方式，需要在创建从属线程之前设置
+        void setTaskQueueType(rs_event_loop_lock_queue::TaskQueueType type)
+        {
+            task_queue_type_ = type;
+        }
+
+        // 设置从属事件循环的事件监控后端，需要在创建从属线程之前设置
+        void setPollerType(rs_poller::PollerType type)
+        {
+            poller_type_ = type;
+        }
+
+        // 设置新连接分配从属事件循环的策略，与getNextLoop在同一线程中调用
+        // 从属线程已经创建时立即构建一致性哈希环
+        void setLoadBalancePolicy(LoadBalancePolicy policy)
+        {
+            policy_ = policy;
+            if (policy_ == LoadBalancePolicy::ConsistentHash && !loops_.empty() && hash_ring_.empty())
+                createHashRing();
+        }
+
+        // 获取所有处理连接的事件循环，没有从属线程时为主事件循环
+        std::vector<rs_event_loop_lock_queue::EventLoopLockQueue *> getAllLoops()
+        {
+            if (thread_num_ == 0)
+                return {base_loop_};
+            return loops_;
+        }
+
+        // 为新连接选择从属事件循环，一致性哈希策略需要传入连接描述符以获取对端地址
+        rs_event_loop_lock_queue::EventLoopLockQueue* getNextLoop(int fd = -1)
         {
             if (thread_num_ == 0)
                 return base_loop_;
+
+            switch (policy_)
+            {
+            case LoadBalancePolicy::LeastConnections:
+                return getLeastLoop([](rs_event_loop_lock_queue::EventLoopLockQueue *loop)
+                                    { return static_cast<int64_t>(loop->getActiveConnections()); });
+            case LoadBalancePolicy::LeastPendingBytes:
+                return getLeastLoop([](rs_event_loop_lock_queue::EventLoopLockQueue *loop)
+                                    { return loop->getPendingBytes(); });
+            case LoadBalancePolicy::LeastLoopLag:
+                return getLeastLoop([](rs_event_loop_lock_queue::EventLoopLockQueue *loop)
+                                    { return static_cast<int64_t>(loop->getLoopLagUs()); });
+            case LoadBalancePolicy::ConsistentHash:
+                if (fd >= 0)
+                {
+                    rs_event_loop_lock_queue::EventLoopLockQueue *loop = getHashLoop(fd);
+                    if (loop)
+                        return loop;
+                }
+                // 无法获取对端地址时退化为轮询
+                break;
+            default:
+                break;
+            }
+
             return loops_[(next_loop_++) % thread_num_];
         }
 
+    private:
+        // 选择负载值最小的事件循环，从轮询位置开始比较，负载相同时依次分配到不同的事件循环
+        template <class LoadGetter>
+        rs_event_loop_lock_queue::EventLoopLockQueue *getLeastLoop(LoadGetter get_load)
+        {
+            int start = (next_loop_++) % thread_num_;
+            rs_event_loop_lock_queue::EventLoopLockQueue *least = loops_[start];
+            int64_t least_load = get_load(least);
+            for (int i = 1; i < thread_num_ && least_load > 0; i++)
+            {
+                rs_event_loop_lock_queue::EventLoopLockQueue *loop = loops_[(start + i) % thread_num_];
+                int64_t load = get_load(loop);
+                if (load < least_load)
+                {
+                    least = loop;
+                    least_load = load;
+                }
+            }
+
+            return least;
+        }
+
+        // FNV-1a哈希
+        static uint32_t hashBytes(const void *data, size_t len)
+        {
+            const unsigned char *bytes = static_cast<const unsigned char *>(data);
+            uint32_t hash = 2166136261u;
+            for (size_t i = 0; i < len; i++)
+            {
+                hash ^= bytes[i];
+                hash *= 16777619u;
+            }
+
+            return hash;
+        }
+
+        // 为每个事件循环在哈希环上放置虚拟节点
+        void createHashRing()
+        {
+            hash_ring_.clear();
+            for (int i = 0; i < thread_num_; i++)
+            {
+                for (int j = 0; j < hash_virtual_nodes; j++)
+                {
+                    std::string node = std::to_string(i) + "#" + std::to_string(j);
+                    hash_ring_.emplace(hashBytes(node.data(), node.size()), i);
+                }
+            }
+        }
+
+        // 根据对端地址（不含端口）在哈希环上查找事件循环，获取地址失败时返回nullptr
+        rs_event_loop_lock_queue::EventLoopLockQueue *getHashLoop(int fd)
+        {
+            struct sockaddr_storage addr;
+            socklen_t len = sizeof(addr);
+            if (getpeername(fd, reinterpret_cast<struct sockaddr *>(&addr), &len) < 0 || hash_ring_.empty())
+                return nullptr;
+
+            uint32_t hash = 0;
+            if (addr.ss_family == AF_INET)
+            {
+                const struct sockaddr_in *addr4 = reinterpret_cast<const struct sockaddr_in *>(&addr);
+                hash = hashBytes(&addr4->sin_addr, sizeof(addr4->sin_addr));
+            }
+            else if (addr.ss_family == AF_INET6)
+            {
+                const struct sockaddr_in6 *addr6 = reinterpret_cast<const struct sockaddr_in6 *>(&addr);
+                hash = hashBytes(&addr6->sin6_addr, sizeof(addr6->sin6_addr));
+            }
+            else
+            {
+                return nullptr;
+            }
+
+            // 顺时针查找第一个虚拟节点，超过最后一个节点时回到环的起点
+            auto pos = hash_ring_.lower_bound(hash);
+            if (pos == hash_ring_.end())
+                pos = hash_ring_.begin();
+
+            return loops_[pos->second];
+        }
+
     private:
         int thread_num_;                                                       // 线程个数
         int next_loop_;                                                        // 下一个从属事件循环监控
         rs_event_loop_lock_queue::EventLoopLockQueue* base_loop_;              // 主事件循环监控
         std::vector<rs_loop_thread::LoopThread::ptr> loop_threads_;            // 管理所有的线程事件监控
         std::vector<rs_event_loop_lock_queue::EventLoopLockQueue*> loops_; // 管理所有的事件循环监控
+        rs_event_loop_lock_queue::TaskQueueType task_queue_type_;          // 从属事件循环任务队列实现方式
+        rs_poller::PollerType poller_type_;                                // 从属事件循环事件监控后端
+        LoadBalancePolicy policy_;                                         // 新连接分配从属事件循环的策略
+        std::map<uint32_t, int> hash_ring_;                                // 一致性哈希环，值为事件循环下标
     };
 }
 
@@ -0,0 +1,87 @@
+#ifndef __rs_mpsc_queue_h__
+#define __rs_mpsc_queue_h__
+
+#include <atomic>
+#include <utility>
+
+namespace rs_mpsc_queue
+{
+    /**
+     * 无锁多生产者单消费者队列
+     * 生产者只需要一次原子交换即可入队，消费者出队不需要任何原子读-改-写操作
+     * 任意线程都可以调用push，只有唯一的消费者线程可以调用pop
+     */
+    template <typename T>
+    class MpscQueue
+    {
+        struct Node
+        {
+            std::atomic<Node *> next;
+            T value;
+
+            Node()
+                : next(nullptr)
+            {
+            }
+
+            explicit Node(T &&v)
+                : next(nullptr), value(std::move(v))
+            {
+            }
+        };
+
+    public:
+        MpscQueue()
+            : head_(new Node()), tail_(head_.load(std::memory_order_relaxed))
+        {
+        }
+
+        MpscQueue(const MpscQueue &) = delete;
+        MpscQueue &operator=(const MpscQueue &) = delete;
+
+        // 入队，可以在任意线程中调用
+        void push(T value)
+        {
+            Node *node = new Node(std::move(value));
+            // 先抢占队尾，再将前一个节点链接到新节点
+            Node *prev = head_.exchange(node, std::memory_order_acq_rel);
+            prev->next.store(node, std::memory_order_release);
+        }
+
+        // 出队，只能在消费者线程中调用
+        // 队列为空或者生产者尚未完成链接时返回false
+        bool pop(T &out)
+        {
+            Node *next = tail_->next.load(std::memory_order_acquire);
+            if (next == nullptr)
+                return false;
+
+            out = std::move(next->value);
+            // next成为新的哨兵节点，其中的值已经被取走
+            delete tail_;
+            tail_ = next;
+            return true;
+        }
+
+        // 判断队列是否为空，只能在消费者线程中调用
+        bool empty() const
+        {
+            return tail_->next.load(std::memory_order_acquire) == nullptr;
+        }
+
+        ~MpscQueue()
+        {
+            T value;
+            while (pop(value))
+            {
+            }
+            delete tail_;
+        }
+
+    private:
+        std::atomic<Node *> head_; // 生产者入队位置
+        Node *tail_;               // 消费者出队位置（哨兵节点）
+    };
+}
+
+#endif
@@ -3,11 +3,13 @@
 
 #include <sys/epoll.h>
 #include <array>
-#include <unordered_map>
+#include <atomic>
 #include <vector>
+#include <algorithm>
 #include <reactor_server/base/log.h>
 #include <reactor_server/base/error.h>
 #include <reactor_server/net/channel.h>
+#include <reactor_server/net/io_uring_poller.h>
 
 namespace rs_poller
 {
@@ -15,93 +17,163 @@ namespace rs_poller
 
     const int max_ready_events = 1024;
 
+    // 事件监控后端
+    enum class PollerType
+    {
+        Epoll,  // epoll
+        IoUring // io_uring，内核不支持时退化为epoll
+    };
+
     // 对epoll操作的封装以及上层使用简化
     class Poller
     {
     public:
         using ptr = std::shared_ptr<Poller>;
 
-        Poller()
+        Poller(PollerType type = PollerType::Epoll)
+            : epfd_(-1)
         {
+            if (type == PollerType::IoUring)
+            {
+                uring_ = std::make_shared<rs_io_uring_poller::IoUringPoller>();
+                if (uring_->init())
+                    return;
+                LOG(Level::Warning, "io_uring不可用，使用epoll");
+                uring_.reset();
+            }
+
             epfd_ = epoll_create(256);
             if(epfd_ < 0)
             {
                 LOG(Level::Error, "创建Epoll模型失败");
                 exit(static_cast<int>(rs_error::ErrorNum::Epoll_create_fail));
             }
+            ready_channels_.reserve(max_ready_events);
         }
 
         // 添加/更新指定描述符的事件监控
-        void updateEvent(rs_channel::Channel::ptr channel)
+        void updateEvent(rs_channel::Channel *channel)
         {
+            if (uring_)
+            {
+                uring_->updateEvent(channel);
+                return;
+            }
+
             // 存在就更新，不存在就添加
-            int fd = channel->getFd();
-            auto pos = channels_.try_emplace(fd, channel);
-            if(pos.second)
-                update(EPOLL_CTL_ADD, channel);
-            else
+            if (!channel->isInPoller())
+            {
+                // 添加失败时保持未添加状态，下一次更新时重新添加
+                if (update(EPOLL_CTL_ADD, channel))
+                    channel->setInPoller(true);
+            }
+            else if (channel->getEvents() != channel->getAppliedEvents())
+            {
+                // 关心的事件没有变化时不需要再次调用epoll_ctl
                 update(EPOLL_CTL_MOD, channel);
+            }
         }
 
         // 移除指定描述符的事件监控
-        void removeEvent(rs_channel::Channel::ptr channel)
+        void removeEvent(rs_channel::Channel *channel)
         {
-            auto it = channels_.find(channel->getFd());
-            if(it == channels_.end())
+            if (uring_)
+            {
+                uring_->removeEvent(channel);
+                return;
+            }
+
+            if (!channel->isInPoller())
                 return;
             update(EPOLL_CTL_DEL, channel);
-            channels_.erase(channel->getFd());
+            channel->setInPoller(false);
+            channel->setAppliedEvents(0);
+
+            // 本轮就绪数组中可能还有尚未处理的该Channel，置空防止后续访问已经移除（可能已经释放）的Channel
+            std::replace(ready_channels_.begin(), ready_channels_.end(), channel, static_cast<rs_channel::Channel *>(nullptr));
         }
 
-        // 开启监控并获取就绪数组
-        int startEpoll(std::vector<rs_channel::Channel::ptr> &channels)
+        // 开启监控并获取就绪数组，超时时间为-1时阻塞等待，为0时立即返回
+        // 就绪数组由Poller持有并在每一轮复用，其中可能存在已经被移除而置空的元素
+        std::vector<rs_channel::Channel *> &startEpoll(int timeout = -1)
         {
-            // 阻塞等待
-            int nfds = epoll_wait(epfd_, epoll_events_.data(), max_ready_events, -1);
+            if (uring_)
+                return uring_->startEpoll(timeout != 0);
+
+            ready_channels_.clear();
+
+            int nfds = epoll_wait(epfd_, epoll_events_.data(), max_ready_events, timeout);
             if(nfds < 0)
             {
                 // 被中断打断，属于可接受范围
                 if(errno == EINTR)
-                    return 0;
+                    return ready_channels_;
                 LOG(Level::Error, "事件等待失败：{}", strerror(errno));
                 exit(static_cast<int>(rs_error::ErrorNum::Epoll_wait_fail));
             }
 
             // 等待成功将就绪的事件监控结构返回
+            // 注册时已经将Channel的地址存入epoll_event中，直接取出即可
             for(int i = 0; i < nfds; i++)
             {
-                // 判断指定文件描述符是否存在
-                auto it = channels_.find(epoll_events_[i].data.fd);
-                assert(it != channels_.end());
-                // 存在再设置对应的就绪事件
-                auto channel = it->second;
+                auto channel = static_cast<rs_channel::Channel *>(epoll_events_[i].data.ptr);
                 channel->setReadyEvents(epoll_events_[i].events);
-                channels.emplace_back(channel);
+                ready_channels_.push_back(channel);
             }
 
-            return nfds;
+            return ready_channels_;
+        }
+
+        // 获取当前使用的事件监控后端
+        PollerType getPollerType()
+        {
+            return uring_ ? PollerType::IoUring : PollerType::Epoll;
+        }
+
+        // 是否以完成方式处理设置了完成方式的Channel的可读事件，只有io_uring后端支持
+        bool isCompletionEnabled()
+        {
+            return uring_ && uring_->isCompletionEnabled();
+        }
+
+        // 获取epoll_ctl调用次数，可以在任意线程中调用
+        // io_uring后端返回提交的poll请求变化次数
+        uint64_t getEpollCtlCount()
+        {
+            if (uring_)
+                return uring_->getCtlCount();
+            return epoll_ctl_count_.load(std::memory_order_relaxed);
         }
 
     private:
-        // 直接进行epoll_ctl的操作封装
-        void update(int op, rs_channel::Channel::ptr channel)
+        // 直接进行epoll_ctl的操作封装，只有调用成功时才记录已经生效的事件
+        // 失败时保留原来的记录，使得下一次更新不会因为事件没有变化而被跳过
+        bool update(int op, rs_channel::Channel *channel)
         {
             int fd = channel->getFd();
             struct epoll_event ev;
-            ev.data.fd = fd;
+            ev.data.ptr = channel;
             ev.events = channel->getEvents();
+            epoll_ctl_count_.fetch_add(1, std::memory_order_relaxed);
             int ret = epoll_ctl(epfd_, op, fd, &ev);
             if(ret < 0)
             {
-                LOG(Level::Error, "添加文件描述符监控失败");
+                LOG(Level::Error, "添加文件描述符监控失败：{}", strerror(errno));
                 // exit(static_cast<int>(rs_error::ErrorNum::Epoll_ctl_fail));
+                return false;
             }
+            if (op != EPOLL_CTL_DEL)
+                channel->setAppliedEvents(ev.events);
+
+            return true;
         }
 
     private:
         int epfd_;                                                     // epoll文件描述符
         std::array<struct epoll_event, max_ready_events> epoll_events_; // 就绪事件数组
-        std::unordered_map<int, rs_channel::Channel::ptr> channels_;    // 管理的事件监控结构
+        std::vector<rs_channel::Channel *> ready_channels_;              // 本轮就绪的事件监控结构
+        std::atomic<uint64_t> epoll_ctl_count_{0};                        // epoll_ctl调用次数
+        rs_io_uring_poller::IoUringPoller::ptr uring_;                   // io_uring后端，为空时使用epoll
     };
 }
 
@@ -96,6 +96,16 @@ namespace rs_socket
             return newfd;
         }
 
+        // 获取客户端连接，新连接直接设置为非阻塞并在exec时关闭
+        // 失败时返回-1并保留errno，由调用方区分暂无连接与描述符耗尽等情况
+        int acceptNonBlock()
+        {
+            struct sockaddr_in addr;
+            socklen_t len = sizeof(addr);
+
+            return ::accept4(sockfd_, reinterpret_cast<struct sockaddr *>(&addr), &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        }
+
         // 客户端发起连接
         bool connect(const std::string &ip = default_ip, uint16_t port = default_port)
         {
@@ -132,7 +142,7 @@ namespace rs_socket
         }
 
         // 发送
-        ssize_t send_nonBlock(void *buf, size_t len)
+        ssize_t send_nonBlock(const void *buf, size_t len)
         {
             return send_block(buf, len, MSG_DONTWAIT);
         }
@@ -210,6 +220,12 @@ namespace rs_socket
             setsockopt(sockfd_, SOL_SOCKET, SO_REUSEPORT, (void *)&val, sizeof(int));
         }
 
+        // 设置套接字忙轮询时间（微秒），超过系统配置的上限时需要CAP_NET_ADMIN权限
+        bool setBusyPoll(int busy_poll_us)
+        {
+            return setsockopt(sockfd_, SOL_SOCKET, SO_BUSY_POLL, (void *)&busy_poll_us, sizeof(int)) == 0;
+        }
+
         // 开启套接字非阻塞
         void setSocketNonBlock()
         {
@@ -1,24 +1,87 @@
 #ifndef __rs_tcp_server_h__
 #define __rs_tcp_server_h__
 
+#include <atomic>
+#include <vector>
 #include <unordered_map>
 #include <reactor_server/net/acceptor.h>
 #include <reactor_server/net/connection.h>
 #include <reactor_server/net/timing_wheel.h>
-#include <reactor_server/base/uuid_generator.h>
 #include <reactor_server/net/event_loop_lock_queue.h>
 #include <reactor_server/net/loop_thread_pool.h>
 
 namespace rs_tcp_server
 {
+    using namespace rs_log_system;
+
+    // 连接在管理结构中的句柄，由槽位下标和代数组成，与定时任务句柄相同
+    // 槽位释放时代数递增，过期的句柄不会移除复用同一槽位的连接
+    struct ConnectionSlot
+    {
+        uint32_t index = 0;
+        uint32_t generation = 0; // 0表示无效句柄
+    };
+
+    // 单个事件循环管理的连接，以槽位数组存放，加入与移除只在对应的事件循环线程中执行
+    struct ConnectionRegistry
+    {
+        using ptr = std::shared_ptr<ConnectionRegistry>;
+
+        struct Slot
+        {
+            rs_connection::Connection::ptr con;
+            uint32_t generation = 1;
+        };
+
+        std::vector<Slot> slots;           // 连接槽位，空槽位的连接为空
+        std::vector<uint32_t> free_slots;  // 空闲的槽位下标
+        std::atomic<size_t> count{0};      // 连接个数，可以在任意线程中读取
+
+        ConnectionSlot add(const rs_connection::Connection::ptr &con)
+        {
+            uint32_t index = 0;
+            if (!free_slots.empty())
+            {
+                index = free_slots.back();
+                free_slots.pop_back();
+            }
+            else
+            {
+                index = static_cast<uint32_t>(slots.size());
+                slots.emplace_back();
+            }
+            slots[index].con = con;
+            count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+            return ConnectionSlot{index, slots[index].generation};
+        }
+
+        void remove(ConnectionSlot id, const rs_connection::Connection::ptr &con)
+        {
+            if (id.generation == 0 || id.index >= slots.size())
+                return;
+            Slot &slot = slots[id.index];
+            if (slot.generation != id.generation || slot.con != con)
+                return;
+
+            slot.con.reset();
+            if (++slot.generation == 0)
+                slot.generation = 1;
+            free_slots.push_back(id.index);
+            count.store(count.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+        }
+    };
+
     class TcpServer
     {
     public:
+        // 遍历连接时的回调
+        using connectionVisitor_t = std::function<void(const rs_connection::Connection::ptr &)>;
+
         TcpServer(int port)
-            : thread_num_(0), enable_timeout_release_(false), base_loop_(std::make_shared<rs_event_loop_lock_queue::EventLoopLockQueue>()), acceptor_(std::make_shared<rs_acceptor::Acceptor>(base_loop_.get(), port)), loop_pool_(std::make_shared<rs_loop_thread_pool::LoopThreadPool>(base_loop_.get()))
+            : port_(port), thread_num_(0), next_conn_id_(0), enable_timeout_release_(false), edge_triggered_(false), deferred_update_(false), reuse_port_accept_(false), accept_budget_(rs_acceptor::default_accept_budget), busy_poll_us_(0), so_busy_poll_us_(0), base_loop_(std::make_shared<rs_event_loop_lock_queue::EventLoopLockQueue>()), loop_pool_(std::make_shared<rs_loop_thread_pool::LoopThreadPool>(base_loop_.get()))
         {
-            acceptor_->setAcceptCallback(std::bind(&TcpServer::handleAccept, this, std::placeholders::_1));
-            acceptor_->enableConcerningAcceptFd();
+            // 监听套接字在start中根据是否复用端口创建，构造时不绑定端口
         }
 
         void setThreadNum(int num)
@@ -27,9 +90,81 @@ namespace rs_tcp_server
             loop_pool_->setThreadNum(thread_num_);
         }
 
+        // 设置从属事件循环的任务队列实现方式，需要在start之前设置
+        void setTaskQueueType(rs_event_loop_lock_queue::TaskQueueType type)
+        {
+            loop_pool_->setTaskQueueType(type);
+        }
+
+        // 设置新连接分配从属事件循环的策略，需要在start之前设置
+        // 复用端口模式下连接由内核分配，该策略不生效
+        void setLoadBalancePolicy(rs_loop_thread_pool::LoadBalancePolicy policy)
+        {
+            loop_pool_->setLoadBalancePolicy(policy);
+        }
+
+        // 设置从属事件循环的事件监控后端，需要在start之前设置，主事件循环始终使用epoll
+        void setPollerType(rs_poller::PollerType type)
+        {
+            loop_pool_->setPollerType(type);
+        }
+
+        // 所有事件循环启用事件关心延迟更新，需要在start之前设置
+        void enableDeferredEventUpdate()
+        {
+            deferred_update_ = true;
+        }
+
+        // 每个事件循环各自持有监听套接字并在本线程内获取连接，需要在start之前设置
+        // 监听套接字通过SO_REUSEPORT绑定同一端口，由内核分配新连接，连接不需要再转交给从属线程
+        void enableReusePortAccept()
+        {
+            reuse_port_accept_ = true;
+        }
+
+        // 设置单次可读事件最多获取的连接数，需要在start之前设置
+        void setAcceptBudget(int budget)
+        {
+            accept_budget_ = budget;
+        }
+
+        // 处理连接的事件循环启用忙轮询，需要在start之前设置
+        // so_busy_poll_us大于0时同时为新连接设置SO_BUSY_POLL，由内核在读取时忙轮询网卡队列
+        void enableBusyPoll(uint32_t spin_us, int so_busy_poll_us = 0)
+        {
+            busy_poll_us_ = spin_us;
+            so_busy_poll_us_ = so_busy_poll_us;
+            if (so_busy_poll_us_ <= 0)
+                return;
+
+            // 超过系统配置的上限时需要权限，提前检查一次，避免每个连接设置失败
+            rs_socket::Socket probe;
+            if (!probe.socket() || !probe.setBusyPoll(so_busy_poll_us_))
+            {
+                LOG(Level::Warning, "设置SO_BUSY_POLL失败：{}", strerror(errno));
+                so_busy_poll_us_ = 0;
+            }
+        }
+
         void start()
         {
             loop_pool_->createLoopThread();
+            createRegistries();
+            if (deferred_update_)
+            {
+                base_loop_->enableDeferredUpdate();
+                for (auto loop : loop_pool_->getAllLoops())
+                    loop->enableDeferredUpdate();
+            }
+            if (busy_poll_us_ > 0)
+            {
+                for (auto loop : loops_)
+                    loop->enableBusyPoll(busy_poll_us_);
+            }
+            if (reuse_port_accept_)
+                createLoopAcceptors();
+            else
+                createBaseAcceptor();
             base_loop_->startEventLoop();
         }
 
@@ -39,11 +174,62 @@ namespace rs_tcp_server
             enable_timeout_release_ = true;
         }
 
+        // 新连接使用边缘触发模式，需要在start之前设置
+        void enableEdgeTriggered()
+        {
+            edge_triggered_ = true;
+        }
+
         void runTask(const rs_schedule_task::ScheduleTask::main_task_t &task, uint32_t timeout)
         {
             base_loop_->runTasks(std::bind(&TcpServer::runTaskInLoop, this, task, timeout));
         }
 
+        // 获取主事件循环，用于监听连接之外的描述符
+        rs_event_loop_lock_queue::EventLoopLockQueue *getBaseLoop()
+        {
+            return base_loop_.get();
+        }
+
+        // 获取所有事件循环管理的连接总数，可以在任意线程中调用
+        size_t getConnectionCount()
+        {
+            size_t total = 0;
+            for (auto &registry : registries_)
+                total += registry->count.load(std::memory_order_relaxed);
+            return total;
+        }
+
+        // 获取所有处理连接的事件循环的统计快照，下标与事件循环创建顺序一致，可以在任意线程中调用
+        std::vector<rs_loop_stats::LoopStatsSnapshot> getLoopStats()
+        {
+            std::vector<rs_loop_stats::LoopStatsSnapshot> stats;
+            for (auto loop : loops_)
+                stats.push_back(loop->getLoopStats());
+            return stats;
+        }
+
+        // 遍历所有连接，回调在每个连接所属的事件循环线程中执行，函数返回时遍历可能尚未完成
+        // 需要在start之后调用
+        void forEachConnection(const connectionVisitor_t &cb)
+        {
+            for (size_t i = 0; i < loops_.size(); i++)
+            {
+                loops_[i]->runTasks([this, i, cb]()
+                                    {
+                    // 回调中可能释放连接，先复制再遍历
+                    std::vector<rs_connection::Connection::ptr> conns;
+                    conns.reserve(registries_[i]->count.load(std::memory_order_relaxed));
+                    for (auto &slot : registries_[i]->slots)
+                    {
+                        if (slot.con)
+                            conns.push_back(slot.con);
+                    }
+                    for (auto &con : conns)
+                        cb(con); });
+            }
+        }
+
         void setConnectedCallback(const rs_connection::Connection::connectedCallback_t &cb)
         {
             con_cb_ = cb;
@@ -65,53 +251,129 @@ namespace rs_tcp_server
         }
 
     private:
-        void handleAccept(int newfd)
+        // 创建连接并设置回调函数，连接ID单调递增不会重复
+        rs_connection::Connection::ptr createConnection(rs_event_loop_lock_queue::EventLoopLockQueue *loop, int newfd)
         {
-            // 创建客户端套接字结构
-            const std::string id = rs_uuid_generator::UuidGenerator::generate_uuid();
-            rs_connection::Connection::ptr client = std::make_shared<rs_connection::Connection>(loop_pool_->getNextLoop(), id, newfd);
+            uint64_t id = next_conn_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+            rs_connection::Connection::ptr client = std::make_shared<rs_connection::Connection>(loop, id, newfd);
 
+            // 连接在所属事件循环的批量任务中建立，超时定时任务在建立时添加
             if (enable_timeout_release_)
-                client->enableTimeoutRelease(timeout_);
+                client->presetTimeoutRelease(timeout_);
+            if (edge_triggered_)
+                client->enableEdgeTriggered();
+            if (so_busy_poll_us_ > 0)
+                client->setBusyPoll(so_busy_poll_us_);
 
             client->setConnectedCallback(con_cb_);
             client->setMessageCallback(msg_cb_);
             client->setOuterCloseCallback(outer_close_cb_);
-            client->setInnerCloseCallback(std::bind(&TcpServer::handleClose, this, std::placeholders::_1));
-            client->establishAfterConnected();
 
-            // 管理连接的客户端
-            auto pos = conns_.try_emplace(id, client);
+            return client;
         }
 
-        void handleClose(const rs_connection::Connection::ptr &con)
+        // 为每个事件循环创建连接管理结构
+        void createRegistries()
         {
-            base_loop_->runTasks(std::bind(&TcpServer::handleCloseInLoop, this, con));
+            loops_ = loop_pool_->getAllLoops();
+            for (size_t i = 0; i < loops_.size(); i++)
+            {
+                registries_.push_back(std::make_shared<ConnectionRegistry>());
+                loop_index_[loops_[i]] = i;
+            }
         }
 
-        void handleCloseInLoop(const rs_connection::Connection::ptr &con)
+        void handleAccept(const std::vector<int> &fds)
         {
-            std::string id = con->getId();
-            auto pos = conns_.find(id);
-            if (pos == conns_.end())
-                return;
-            conns_.erase(pos);
+            // 同一批次中分配给同一事件循环的连接合并为一个任务，减少跨线程唤醒
+            std::vector<std::vector<rs_connection::Connection::ptr>> batches(loops_.size());
+            for (int newfd : fds)
+            {
+                // 创建客户端套接字结构
+                rs_event_loop_lock_queue::EventLoopLockQueue *loop = loop_pool_->getNextLoop(newfd);
+                batches[loop_index_[loop]].push_back(createConnection(loop, newfd));
+            }
+
+            // 连接在所属的事件循环线程中加入连接管理结构并启动
+            for (size_t i = 0; i < batches.size(); i++)
+            {
+                if (batches[i].empty())
+                    continue;
+                loops_[i]->runTasks([this, i, clients = std::move(batches[i])]()
+                                    {
+                    for (auto &client : clients)
+                        registerConnection(i, client); });
+            }
+        }
+
+        // 在主事件循环中创建监听套接字，获取到的连接分配给从属事件循环
+        void createBaseAcceptor()
+        {
+            acceptor_ = std::make_shared<rs_acceptor::Acceptor>(base_loop_.get(), port_);
+            acceptor_->setAcceptBudget(accept_budget_);
+            acceptor_->setAcceptBatchCallback(std::bind(&TcpServer::handleAccept, this, std::placeholders::_1));
+            acceptor_->enableConcerningAcceptFd();
+        }
+
+        // 为每个事件循环创建绑定同一端口的监听套接字
+        void createLoopAcceptors()
+        {
+            for (size_t i = 0; i < loops_.size(); i++)
+            {
+                rs_acceptor::Acceptor::ptr acceptor = std::make_shared<rs_acceptor::Acceptor>(loops_[i], port_);
+                acceptor->setAcceptBudget(accept_budget_);
+                acceptor->setAcceptCallback(std::bind(&TcpServer::handleLoopAccept, this, i, std::placeholders::_1));
+                // 事件关心需要在对应的事件循环线程中启用
+                loops_[i]->runTasks(std::bind(&rs_acceptor::Acceptor::enableConcerningAcceptFd, acceptor.get()));
+                loop_acceptors_.push_back(acceptor);
+            }
+        }
+
+        // 在获取连接的事件循环线程中直接创建并管理连接
+        void handleLoopAccept(size_t index, int newfd)
+        {
+            registerConnection(index, createConnection(loops_[index], newfd));
+        }
+
+        // 在连接所属的事件循环线程中管理连接并启动连接，启动时会在当前线程内直接执行
+        void registerConnection(size_t index, const rs_connection::Connection::ptr &client)
+        {
+            ConnectionSlot slot = registries_[index]->add(client);
+            client->setInnerCloseCallback(std::bind(&TcpServer::handleClose, this, index, slot, std::placeholders::_1));
+            client->establishAfterConnected();
+        }
+
+        // 连接释放在其所属的事件循环线程中执行，直接从对应的连接管理结构中移除，不需要跨线程
+        // 槽位句柄在加入时绑定到关闭回调中，移除时直接定位槽位，不需要查找
+        void handleClose(size_t index, ConnectionSlot slot, const rs_connection::Connection::ptr &con)
+        {
+            registries_[index]->remove(slot, con);
         }
 
         void runTaskInLoop(const rs_schedule_task::ScheduleTask::main_task_t &task, uint32_t timeout)
         {
-            std::string id = rs_uuid_generator::UuidGenerator::generate_uuid();
-            base_loop_->insertTask(id, timeout, task);
+            base_loop_->insertTask(timeout, task);
         }
 
     private:
+        int port_;
         int thread_num_;
+        std::atomic<uint64_t> next_conn_id_; // 上一个分配的连接ID，复用端口模式下多个线程同时分配
         bool enable_timeout_release_;
+        bool edge_triggered_;
+        bool deferred_update_;
+        bool reuse_port_accept_; // 是否每个事件循环各自获取连接
+        int accept_budget_;      // 单次可读事件最多获取的连接数
+        uint32_t busy_poll_us_;  // 处理连接的事件循环忙轮询时间（微秒）
+        int so_busy_poll_us_;    // 新连接的SO_BUSY_POLL时间（微秒）
         uint32_t timeout_;
         rs_event_loop_lock_queue::EventLoopLockQueue::ptr base_loop_;
-        rs_acceptor::Acceptor::ptr acceptor_;
+        rs_acceptor::Acceptor::ptr acceptor_;  // 主事件循环的监听模块，复用端口模式下不创建
         rs_loop_thread_pool::LoopThreadPool::ptr loop_pool_;
-        std::unordered_map<std::string, rs_connection::Connection::ptr> conns_;
+        std::vector<rs_event_loop_lock_queue::EventLoopLockQueue *> loops_;                  // 所有处理连接的事件循环
+        std::unordered_map<rs_event_loop_lock_queue::EventLoopLockQueue *, size_t> loop_index_; // 事件循环在loops_中的下标
+        std::vector<ConnectionRegistry::ptr> registries_;                                      // 每个事件循环各自管理的连接
+        std::vector<rs_acceptor::Acceptor::ptr> loop_acceptors_;                               // 复用端口模式下每个事件循环的监听模块
 
         rs_connection::Connection::connectedCallback_t con_cb_;
         rs_connection::Connection::messageCallback_t msg_cb_;
@@ -3,8 +3,12 @@
 
 #include <vector>
 #include <memory>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <ctime>
 #include <sys/timerfd.h>
-#include <unordered_map>
+#include <deque>
 #include <reactor_server/base/log.h>
 #include <reactor_server/base/error.h>
 #include <reactor_server/net/schedule_task.h>
@@ -19,58 +23,107 @@ namespace rs_timing_wheel
 {
     using namespace rs_log_system;
 
+    const int wheel_levels = 5;          // 时间轮层数
+    const int wheel_bits0 = 8;           // 第0层槽位数位数，256个槽位，每个槽位1毫秒
+    const int wheel_bits = 6;            // 其余各层槽位数位数，64个槽位，每个槽位为下一层一圈的时长
+    const uint64_t max_wheel_span = 0xffffffffULL; // 单次放入时间轮的最大跨度（毫秒），超出时在降级时重新计算位置
+
+    // 定时任务句柄：任务节点数组下标以及节点的代数
+    // 任务执行或者取消后节点代数递增，之前的句柄随之失效，节点可以被安全复用
+    struct TimerId
+    {
+        uint32_t index = 0;
+        uint32_t generation = 0; // 0表示无效句柄
+    };
+
+    /**
+     * 分层时间轮，精度为1毫秒
+     * 第0层覆盖256毫秒，之后每层覆盖范围扩大64倍，5层共覆盖约49天，更长的超时时间在降级时重新放置
+     * 任务通过侵入式双向链表挂在槽位上，插入、刷新和取消都是O(1)
+     * 定时器文件描述符只在最近一个需要处理的时刻触发，没有定时任务时不会唤醒事件循环
+     */
     class TimingWheel
     {
+        // 槽位链表节点
+        struct TimerLink
+        {
+            TimerLink *prev;
+            TimerLink *next;
+        };
+
+        // 定时任务节点
+        struct TimerNode : TimerLink
+        {
+            uint64_t expire;                                // 超时时刻（毫秒）
+            uint64_t timeout;                               // 超时时间（毫秒），刷新时使用
+            int level;                                      // 所在层
+            uint32_t index;                                 // 在任务节点数组中的下标
+            uint32_t generation;                            // 节点代数，与句柄中的代数一致时句柄有效
+            bool active;                                    // 是否在时间轮中
+            rs_schedule_task::ScheduleTask::main_task_t task; // 超时后执行的任务
+        };
+
     public:
         using ptr = std::shared_ptr<TimingWheel>;
-        using per_task_ptr_t = std::shared_ptr<rs_schedule_task::ScheduleTask>;
-        using per_task_ptr_t_weak = std::weak_ptr<rs_schedule_task::ScheduleTask>;
 
         TimingWheel(rs_event_loop_lock_queue::EventLoopLockQueue *loop)
-            : capacity_(60), tick_(0), schedule_tasks_(capacity_), timerfd_(getTimerFd()), loop_(loop), timerfd_channel(std::make_shared<rs_channel::Channel>(loop_, timerfd_))
+            : current_(getCurrentMs()), armed_expire_(0), slots_((1 << wheel_bits0) + (wheel_levels - 1) * (1 << wheel_bits)), timer_count_(0), timerfd_(getTimerFd()), loop_(loop), timerfd_channel(std::make_shared<rs_channel::Channel>(loop_, timerfd_))
         {
+            for (auto &slot : slots_)
+                slot.prev = slot.next = &slot;
+            for (int i = 0; i < wheel_levels; i++)
+                level_count_[i] = 0;
             // 设置定时器文件描述符可读事件回调并启用可读事件监听
             timerfd_channel->setReadCallback(std::bind(&TimingWheel::executeTimerTask, this));
             timerfd_channel->enableConcerningReadFd();
         }
 
-        // 将时间轮的任务全部交给EventLoop来处理，确保任务可以在一个线程内执行保证线程安全问题
-        void cancelTask(const std::string &id);
-        void insertTask(const std::string &id, uint32_t timeout, const rs_schedule_task::ScheduleTask::main_task_t &task);
-        void refreshTask(const std::string &id);
+        TimingWheel(const TimingWheel &) = delete;
+        TimingWheel &operator=(const TimingWheel &) = delete;
+
+        // 取消和刷新交给EventLoop来处理，确保任务可以在一个线程内执行保证线程安全问题
+        void cancelTask(TimerId id);
+        void refreshTask(TimerId id);
+        // 新增任务需要立即返回句柄，只能在EventLoop所在线程内调用
+        TimerId insertTask(std::chrono::milliseconds timeout, const rs_schedule_task::ScheduleTask::main_task_t &task);
+
+        // 以秒为单位的超时时间
+        TimerId insertTask(uint32_t timeout, const rs_schedule_task::ScheduleTask::main_task_t &task)
+        {
+            return insertTask(std::chrono::seconds(timeout), task);
+        }
 
         // 定时文件描述符可读事件触发回调
         void executeTimerTask()
         {
-            int gap = readTimerFd();
-            // 根据实际超时次数进行任务处理
-            for(int i = 0; i < gap; i++)
-                runTasks();
+            readTimerFd();
+            // 根据当前时间推进时间轮，处理所有已经到期的任务
+            advance(getCurrentMs());
+            rearm();
         }
 
         // 判断是否存在指定定时器
         // 非线程安全，使用时需要保证在同一线程内
-        bool hasTimer(const std::string &id)
+        bool hasTimer(TimerId id)
         {
-            return static_cast<bool>(task_map_.count(id));
+            return getNode(id) != nullptr;
         }
 
-    private:
-        // 直接从哈希表中删除对应的任务
-        void removeTask(std::string id)
+        // 获取单调时钟当前时间（毫秒），与时间轮使用同一个时钟
+        static uint64_t getCurrentMs()
         {
-            auto pos = task_map_.find(id);
-            if (pos == task_map_.end())
-                return;
-
-            task_map_.erase(id);
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return static_cast<uint64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
         }
 
-        // 创建定时器文件描述符
+    private:
+
+        // 创建定时器文件描述符，之后按需设置一次性超时时刻
         static int getTimerFd()
         {
             // 创建定时器描述符
-            int timer_fd = timerfd_create(CLOCK_MONOTONIC, 0);
+            int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
 
             if (timer_fd < 0)
             {
@@ -78,28 +131,9 @@ namespace rs_timing_wheel
                 exit(static_cast<int>(rs_error::ErrorNum::Timerfd_create_fail));
             }
 
-            // 设置定时器
-            struct itimerspec timer;
-            // 初始时间
-            timer.it_interval.tv_sec = 1;
-            timer.it_interval.tv_nsec = 0; // 纳秒为0，防止随机值
-            // 间隔时间
-            timer.it_value.tv_sec = 1;
-            timer.it_value.tv_nsec = 0;
-
-            timerfd_settime(timer_fd, 0, &timer, NULL);
-
             return timer_fd;
         }
 
-        // 执行任务函数，每秒执行1次的函数
-        void runTasks()
-        {
-            tick_ = (tick_ + 1) % capacity_;
-            // 销毁时间轮数组对应的任务对象集合，自动执行所有任务
-            schedule_tasks_[tick_].clear();
-        }
-
         // 读取定时器文件描述符
         int readTimerFd()
         {
@@ -116,50 +150,307 @@ namespace rs_timing_wheel
             return gap;
         }
 
-        // 取消任务
-        void cancelTaskInLoop(std::string id)
+        // 设置定时器文件描述符在指定时刻触发，0表示停止
+        void armTimerFd(uint64_t expire)
+        {
+            struct itimerspec timer = {};
+            timer.it_value.tv_sec = expire / 1000;
+            timer.it_value.tv_nsec = (expire % 1000) * 1000000;
+            timerfd_settime(timerfd_, TFD_TIMER_ABSTIME, &timer, NULL);
+            armed_expire_ = expire;
+        }
+
+        // 根据下一个需要处理的时刻重新设置定时器文件描述符
+        void rearm()
         {
-            // 通过id找到对应的任务
-            auto pos = task_map_.find(id);
-            if (pos == task_map_.end())
+            uint64_t next = getNextTick();
+            if (next == std::numeric_limits<uint64_t>::max())
+            {
+                if (armed_expire_ != 0)
+                    armTimerFd(0);
                 return;
+            }
 
-            per_task_ptr_t pt = pos->second.lock();
-            if (pt)
-                pt->cancelTask();
+            if (next != armed_expire_)
+                armTimerFd(next);
         }
 
-        // 新增任务
-        void insertTaskInLoop(const std::string &id, uint32_t timeout, const rs_schedule_task::ScheduleTask::main_task_t &task)
+        // 第level层槽位下标的起始位移
+        static int getShift(int level)
         {
-            // 构造任务对象
-            per_task_ptr_t pt(new rs_schedule_task::ScheduleTask(id, timeout, task));
-            pt->setReleaseTask(std::bind(&TimingWheel::removeTask, this, id));
-            int pos = (tick_ + timeout) % capacity_;
-            schedule_tasks_[pos].push_back(pt);
-            task_map_.try_emplace(id, pt);
+            return level == 0 ? 0 : wheel_bits0 + (level - 1) * wheel_bits;
+        }
+
+        // 获取第level层第index个槽位
+        TimerLink *getSlot(int level, size_t index)
+        {
+            size_t offset = level == 0 ? 0 : (1 << wheel_bits0) + (level - 1) * (1 << wheel_bits);
+            return &slots_[offset + index];
+        }
+
+        static void linkTail(TimerLink *head, TimerLink *node)
+        {
+            node->prev = head->prev;
+            node->next = head;
+            head->prev->next = node;
+            head->prev = node;
+        }
+
+        static void unlink(TimerLink *node)
+        {
+            node->prev->next = node->next;
+            node->next->prev = node->prev;
+            node->prev = node->next = node;
+        }
+
+        // 将整个槽位链表转移到临时链表头
+        static void splice(TimerLink *from, TimerLink *to)
+        {
+            to->prev = to->next = to;
+            if (from->next == from)
+                return;
+            to->next = from->next;
+            to->prev = from->prev;
+            to->next->prev = to;
+            to->prev->next = to;
+            from->prev = from->next = from;
+        }
+
+        // 根据超时时刻与当前时刻的距离将任务放入对应层的槽位
+        void addNode(TimerNode *node)
+        {
+            uint64_t expire = node->expire < current_ ? current_ : node->expire;
+            uint64_t idx = expire - current_;
+            int level = 0;
+            while (level < wheel_levels - 1 && idx >= (1ULL << (getShift(level + 1))))
+                level++;
+            // 超出最大跨度时先放在最高层，降级时会根据实际超时时刻重新放置
+            if (idx > max_wheel_span)
+                expire = current_ + max_wheel_span;
+
+            size_t mask = level == 0 ? (1 << wheel_bits0) - 1 : (1 << wheel_bits) - 1;
+            size_t index = (expire >> getShift(level)) & mask;
+            node->level = level;
+            level_count_[level]++;
+            linkTail(getSlot(level, index), node);
+        }
+
+        void removeNode(TimerNode *node)
+        {
+            level_count_[node->level]--;
+            unlink(node);
+        }
+
+        // 将上层对应槽位中的任务重新放置到下层，返回槽位下标
+        size_t cascade(int level)
+        {
+            size_t index = (current_ >> getShift(level)) & ((1 << wheel_bits) - 1);
+            TimerLink list;
+            splice(getSlot(level, index), &list);
+            while (list.next != &list)
+            {
+                TimerNode *node = static_cast<TimerNode *>(list.next);
+                removeNode(node);
+                addNode(node);
+            }
+
+            return index;
+        }
+
+        // 获取下一个需要处理的时刻：第0层最近的非空槽位或者上层最近的非空槽位降级的时刻
+        uint64_t getNextTick()
+        {
+            if (timer_count_ == 0)
+                return std::numeric_limits<uint64_t>::max();
+
+            // 上层槽位只在降级时处理，空槽位的降级时刻可以直接跳过
+            uint64_t upper_next = std::numeric_limits<uint64_t>::max();
+            for (int level = 1; level < wheel_levels; level++)
+            {
+                if (level_count_[level] > 0)
+                    upper_next = std::min(upper_next, getNextCascade(level));
+            }
+
+            if (level_count_[0] == 0)
+                return upper_next;
+
+            // 第0层一圈之内一定存在非空槽位，但不能越过上层的降级时刻
+            const uint64_t span0 = 1ULL << wheel_bits0;
+            uint64_t limit = std::min(current_ + span0, upper_next);
+            for (uint64_t t = current_; t < limit; t++)
+            {
+                TimerLink *slot = getSlot(0, t & (span0 - 1));
+                if (slot->next != slot)
+                    return t;
+            }
+
+            return limit;
+        }
+
+        // 获取第level层从当前时刻开始最近的非空槽位降级的时刻
+        // 槽位降级的时刻按该层槽位时长对齐，该层的任务都在一圈之内降级
+        uint64_t getNextCascade(int level)
+        {
+            const int shift = getShift(level);
+            const uint64_t span = 1ULL << shift;
+            const size_t mask = (1 << wheel_bits) - 1;
+            uint64_t t = (current_ + span - 1) & ~(span - 1);
+            for (size_t i = 0; i <= mask; i++, t += span)
+            {
+                TimerLink *slot = getSlot(level, (t >> shift) & mask);
+                if (slot->next != slot)
+                    return t;
+            }
+
+            return std::numeric_limits<uint64_t>::max();
+        }
+
+        // 处理current_时刻：必要时从上层降级，然后执行对应槽位中的任务
+        void tick()
+        {
+            size_t index = current_ & ((1 << wheel_bits0) - 1);
+            if (index == 0)
+            {
+                for (int level = 1; level < wheel_levels; level++)
+                    if (cascade(level) != 0)
+                        break;
+            }
+            // 先推进当前时刻，执行任务时新增的已到期任务放入下一个槽位
+            current_++;
+
+            TimerLink list;
+            splice(getSlot(0, index), &list);
+            while (list.next != &list)
+            {
+                TimerNode *node = static_cast<TimerNode *>(list.next);
+                removeNode(node);
+                // 先释放节点再执行任务，任务中可以重新添加任务并复用该节点
+                auto task = std::move(node->task);
+                freeNode(node);
+                if (task)
+                    task();
+            }
+        }
+
+        // 推进时间轮直到now时刻，跳过没有任务的时刻
+        void advance(uint64_t now)
+        {
+            while (true)
+            {
+                uint64_t next = getNextTick();
+                if (next > now)
+                {
+                    if (current_ <= now)
+                        current_ = now + 1;
+                    return;
+                }
+                if (next > current_)
+                    current_ = next;
+                tick();
+            }
+        }
+
+        // 根据句柄获取任务节点，句柄失效时返回空
+        TimerNode *getNode(TimerId id)
+        {
+            if (id.generation == 0 || id.index >= nodes_.size())
+                return nullptr;
+
+            TimerNode *node = &nodes_[id.index];
+            if (!node->active || node->generation != id.generation)
+                return nullptr;
+
+            return node;
+        }
+
+        // 申请任务节点，优先复用空闲节点
+        uint32_t allocNode()
+        {
+            if (!free_nodes_.empty())
+            {
+                uint32_t index = free_nodes_.back();
+                free_nodes_.pop_back();
+                return index;
+            }
+
+            nodes_.emplace_back();
+            TimerNode &node = nodes_.back();
+            node.prev = node.next = &node;
+            node.index = static_cast<uint32_t>(nodes_.size() - 1);
+            node.generation = 1;
+            node.active = false;
+            return node.index;
+        }
+
+        // 释放任务节点，代数递增使旧句柄失效
+        void freeNode(TimerNode *node)
+        {
+            node->active = false;
+            node->task = nullptr;
+            if (++node->generation == 0)
+                node->generation = 1;
+            timer_count_--;
+            // deque的节点分块存放，不能通过地址相减计算下标
+            free_nodes_.push_back(node->index);
+        }
+
+        // 取消任务
+        void cancelTaskInLoop(TimerId id)
+        {
+            // 通过句柄找到对应的任务，直接从时间轮中移除
+            TimerNode *node = getNode(id);
+            if (node == nullptr)
+                return;
+
+            removeNode(node);
+            freeNode(node);
         }
 
         // 刷新定时任务
-        void refreshTaskInLoop(std::string id)
+        void refreshTaskInLoop(TimerId id)
         {
-            // 通过id找到对应的任务
-            auto pos = task_map_.find(id);
-            if (pos == task_map_.end())
+            // 通过句柄找到对应的任务
+            TimerNode *node = getNode(id);
+            if (node == nullptr)
                 return;
 
             // 根据设置任务时给定的超时时间更新任务下一次的超时时间
-            per_task_ptr_t pt = pos->second.lock();
-            uint32_t timeout = pt->getTimeout();
-            int index = (tick_ + timeout) % capacity_;
-            schedule_tasks_[index].push_back(pt);
+            removeNode(node);
+            schedule(node);
+        }
+
+        // 新增任务
+        TimerId insertTaskInLoop(std::chrono::milliseconds timeout, const rs_schedule_task::ScheduleTask::main_task_t &task)
+        {
+            uint32_t index = allocNode();
+            TimerNode *node = &nodes_[index];
+            node->active = true;
+            node->timeout = timeout.count() > 0 ? timeout.count() : 0;
+            node->task = task;
+            timer_count_++;
+            schedule(node);
+
+            return TimerId{index, node->generation};
+        }
+
+        // 从当前时间开始计时放入时间轮，超时时刻早于已经设置的触发时刻时重新设置定时器
+        void schedule(TimerNode *node)
+        {
+            // 当前时间按毫秒向下取整，多加1毫秒保证任务不会提前执行
+            node->expire = getCurrentMs() + node->timeout + 1;
+            addNode(node);
+            if (armed_expire_ == 0 || node->expire < armed_expire_)
+                armTimerFd(node->expire);
         }
 
     private:
-        int capacity_;                                               // 时间轮数组长度
-        int tick_;                                                   // 当前待销毁（执行）的任务
-        std::vector<std::vector<per_task_ptr_t>> schedule_tasks_;    // 时间轮数组
-        std::unordered_map<std::string, per_task_ptr_t_weak> task_map_; // 管理具体的一个任务，但是不能影响引用计数
+        uint64_t current_;                                       // 时间轮当前待处理的时刻（毫秒）
+        uint64_t armed_expire_;                                  // 定时器文件描述符设置的触发时刻，0表示未设置
+        size_t level_count_[wheel_levels];                       // 每层的任务个数
+        std::vector<TimerLink> slots_;                           // 所有层的槽位链表头
+        size_t timer_count_;                                     // 时间轮中的任务个数
+        std::deque<TimerNode> nodes_;                            // 任务节点数组，扩容时已有节点地址不变
+        std::vector<uint32_t> free_nodes_;                       // 空闲任务节点下标
 
         int timerfd_;                                        // 定时器文件描述符
         rs_event_loop_lock_queue::EventLoopLockQueue *loop_; // 监控定时器文件描述符事件
@@ -167,4 +458,4 @@ namespace rs_timing_wheel
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,89 @@
+/* 建立连接速率测试：比较主事件循环统一获取连接与每个事件循环复用端口各自获取连接两种模式 */
+// 操作：./bench [从属线程数] [客户端线程数] [每种模式测试秒数]
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <reactor_server/net/signal_ign.h>
+#include <reactor_server/net/tcp_server.h>
+
+// 启动服务器，连接建立后服务端立即关闭连接
+void startServer(int port, int threads, bool reuse_port)
+{
+    auto server = new rs_tcp_server::TcpServer(port);
+    server->setThreadNum(threads);
+    if (reuse_port)
+        server->enableReusePortAccept();
+    server->setConnectedCallback([](const rs_connection::Connection::ptr &con)
+                                 { con->shutdown(); });
+    std::thread([server]()
+                { server->start(); })
+        .detach();
+}
+
+// 客户端不断建立连接并等待服务端关闭，返回每秒完成的连接数
+double runBench(int port, int clients, int seconds)
+{
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> total(0);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < clients; i++)
+    {
+        threads.emplace_back([&]()
+                             {
+            struct sockaddr_in addr = {};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(port);
+            addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+            size_t count = 0;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+                // 主动关闭方为服务端，客户端不会积累TIME_WAIT
+                if (::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == 0)
+                {
+                    char buf[16];
+                    if (::recv(fd, buf, sizeof(buf), 0) == 0)
+                        count++;
+                }
+                ::close(fd);
+            }
+            total.fetch_add(count); });
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    stop = true;
+    for (auto &t : threads)
+        t.join();
+
+    return static_cast<double>(total) / seconds;
+}
+
+int main(int argc, char *argv[])
+{
+    int threads = argc > 1 ? std::atoi(argv[1]) : 4;
+    int clients = argc > 2 ? std::atoi(argv[2]) : 8;
+    int seconds = argc > 3 ? std::atoi(argv[3]) : 3;
+
+    // 两种模式的服务器使用不同端口，常驻到进程退出
+    startServer(8090, threads, false);
+    startServer(8091, threads, true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    std::printf("从属线程：%d，客户端线程：%d\n", threads, clients);
+    std::printf("%-12s %16s\n", "mode", "conns/s");
+    std::printf("%-12s %16.0f\n", "base-accept", runBench(8090, clients, seconds));
+    std::printf("%-12s %16.0f\n", "reuse-port", runBench(8091, clients, seconds));
+
+    std::fflush(stdout);
+    std::_Exit(0);
+}
@@ -0,0 +1,292 @@
+#include <reactor_server/net/signal_ign.h>
+#include <reactor_server/net/acceptor.h>
+#include <reactor_server/net/tcp_server.h>
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <functional>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+
+using rs_event_loop_lock_queue::EventLoopLockQueue;
+
+const int budget_port = 18231;
+const int shed_port = 18232;
+const int server_port = 18233;
+const int reuse_port = 18234;
+
+// 尝试连接本地端口，失败时返回-1
+int tryConnectLocal(int port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    if (connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// 连接本地端口，三次握手在监听队列中完成，不需要服务端获取连接
+int connectLocal(int port)
+{
+    int fd = tryConnectLocal(port);
+    assert(fd >= 0);
+    return fd;
+}
+
+// 连接是否已经被服务端关闭
+bool isClosedByPeer(int fd)
+{
+    char c;
+    ssize_t n = recv(fd, &c, 1, MSG_DONTWAIT);
+    return n == 0 || (n < 0 && errno == ECONNRESET);
+}
+
+void waitFor(const std::atomic<bool> &flag)
+{
+    while (!flag)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+/**
+ * 在单独的线程中创建事件循环与监听套接字，客户端连接完成并且prepare执行后才开始获取连接
+ * check在开始获取连接timeout之后在事件循环线程中执行，事件循环线程不会退出
+ */
+void runAcceptor(int port, const std::function<void(rs_acceptor::Acceptor &)> &setup, const std::function<void()> &prepare,
+                 std::chrono::milliseconds timeout, const std::function<void(EventLoopLockQueue &)> &check)
+{
+    std::atomic<bool> ready(false), go(false), done(false);
+    std::thread loop_thread([&]()
+                            {
+        EventLoopLockQueue loop;
+        auto acceptor = std::make_shared<rs_acceptor::Acceptor>(&loop, port);
+        setup(*acceptor);
+        ready = true;
+        waitFor(go);
+        acceptor->enableConcerningAcceptFd();
+        loop.insertTask(timeout, [&]()
+                        {
+            check(loop);
+            done = true; });
+        loop.startEventLoop(); });
+    loop_thread.detach();
+
+    waitFor(ready);
+    prepare();
+    go = true;
+    waitFor(done);
+}
+
+// 单次可读事件获取的连接数不超过上限，剩余的连接在之后的事件循环中继续获取
+void testAcceptBudget()
+{
+    std::cout << "测试单次获取连接上限..." << std::endl;
+
+    std::vector<size_t> batches;
+    std::vector<int> accepted;
+    std::vector<int> clients;
+    runAcceptor(budget_port, [&](rs_acceptor::Acceptor &acceptor)
+                {
+        acceptor.setAcceptBudget(4);
+        acceptor.setAcceptBatchCallback([&](const std::vector<int> &fds)
+                                        {
+            batches.push_back(fds.size());
+            accepted.insert(accepted.end(), fds.begin(), fds.end()); }); },
+                [&]()
+                {
+        for (int i = 0; i < 10; i++)
+            clients.push_back(connectLocal(budget_port)); },
+                std::chrono::milliseconds(200), [](EventLoopLockQueue &) {});
+
+    // 每次可读事件最多获取4个连接
+    assert(accepted.size() == 10);
+    assert((batches == std::vector<size_t>{4, 4, 2}));
+
+    for (int fd : accepted)
+        close(fd);
+    for (int fd : clients)
+        close(fd);
+
+    std::cout << "✓ 单次获取连接上限测试通过" << std::endl;
+}
+
+// 文件描述符耗尽时丢弃新连接，监听队列被清空，事件循环不会空转
+void testShedOnExhaustion()
+{
+    std::cout << "测试文件描述符耗尽时丢弃连接..." << std::endl;
+
+    const int client_count = 20;
+    const int allowed = 3;
+    std::vector<int> accepted;
+    std::vector<int> clients;
+    struct rlimit old_limit;
+    uint64_t iterations = 0;
+    runAcceptor(shed_port, [&](rs_acceptor::Acceptor &acceptor)
+                {
+        // 获取到的连接一直持有，模拟文件描述符被占满
+        acceptor.setAcceptCallback([&](int fd)
+                                   { accepted.push_back(fd); }); },
+                [&]()
+                {
+        for (int i = 0; i < client_count; i++)
+            clients.push_back(connectLocal(shed_port));
+        // 只允许再打开allowed个描述符
+        int max_fd = 0;
+        for (int fd : clients)
+            max_fd = std::max(max_fd, fd);
+        getrlimit(RLIMIT_NOFILE, &old_limit);
+        struct rlimit limit = old_limit;
+        limit.rlim_cur = max_fd + 1 + allowed;
+        int ret = setrlimit(RLIMIT_NOFILE, &limit);
+        assert(ret == 0); },
+                std::chrono::milliseconds(300), [&](EventLoopLockQueue &loop)
+                { iterations = loop.getLoopStats().iterations; });
+
+    assert(setrlimit(RLIMIT_NOFILE, &old_limit) == 0);
+
+    // 超出限制的连接全部被关闭，没有留在监听队列中
+    int shed = 0;
+    for (int fd : clients)
+        if (isClosedByPeer(fd))
+            shed++;
+    std::cout << "获取" << accepted.size() << "个连接，丢弃" << shed << "个连接，事件循环" << iterations << "轮" << std::endl;
+    assert(accepted.size() == allowed);
+    assert(shed == client_count - allowed);
+    // 监听队列清空后不再有可读事件，事件循环不会空转
+    assert(iterations < 10);
+
+    for (int fd : accepted)
+        close(fd);
+    for (int fd : clients)
+        close(fd);
+
+    std::cout << "✓ 文件描述符耗尽时丢弃连接测试通过" << std::endl;
+}
+
+// 启用超时释放时，同一批次分配给同一事件循环的连接只产生一个跨线程任务
+void testOneTaskPerBatch()
+{
+    std::cout << "测试批量建立连接..." << std::endl;
+
+    std::atomic<rs_tcp_server::TcpServer *> server_ptr{nullptr};
+    std::thread server_thread([&]()
+                              {
+        rs_tcp_server::TcpServer server(server_port);
+        server.setThreadNum(2);
+        server.enableTimeoutRelease(10);
+        server_ptr = &server;
+        server.start(); });
+    server_thread.detach();
+    while (server_ptr.load() == nullptr)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const int client_count = 16;
+    std::vector<int> clients;
+    for (int i = 0; i < client_count; i++)
+        clients.push_back(connectLocal(server_port));
+    rs_tcp_server::TcpServer *server = server_ptr.load();
+    while (server->getConnectionCount() < client_count)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    // 每个批次一个任务，连接建立和添加超时定时任务都在该任务中完成
+    uint64_t tasks = 0;
+    for (auto &stats : server->getLoopStats())
+        tasks += stats.tasks_per_drain.sum;
+    std::cout << client_count << "个连接共执行" << tasks << "个任务" << std::endl;
+    assert(tasks > 0 && tasks <= client_count);
+
+    for (int fd : clients)
+        close(fd);
+
+    std::cout << "✓ 批量建立连接测试通过" << std::endl;
+}
+
+// 复用端口模式下只有从属事件循环监听端口，构造服务器时不绑定端口
+void testReusePortListenOnStart()
+{
+    std::cout << "测试复用端口模式的监听套接字..." << std::endl;
+
+    std::atomic<rs_tcp_server::TcpServer *> server_ptr{nullptr};
+    std::atomic<bool> go(false);
+    std::thread server_thread([&]()
+                              {
+        rs_tcp_server::TcpServer server(reuse_port);
+        server.setThreadNum(2);
+        server.enableReusePortAccept();
+        server_ptr = &server;
+        waitFor(go);
+        server.start(); });
+    server_thread.detach();
+    while (server_ptr.load() == nullptr)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    // start之前没有任何监听套接字，连接被拒绝
+    assert(tryConnectLocal(reuse_port) < 0);
+    go = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // 所有连接都由从属事件循环获取并管理
+    const int client_count = 16;
+    std::vector<int> clients;
+    for (int i = 0; i < client_count; i++)
+        clients.push_back(connectLocal(reuse_port));
+    rs_tcp_server::TcpServer *server = server_ptr.load();
+    for (int i = 0; i < 2000 && server->getConnectionCount() < client_count; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    assert(server->getConnectionCount() == client_count);
+    for (int fd : clients)
+        assert(!isClosedByPeer(fd));
+
+    // 连接关闭后从槽位中移除，新连接复用空闲槽位，遍历只访问存在的连接
+    for (int fd : clients)
+        close(fd);
+    clients.clear();
+    for (int i = 0; i < 2000 && server->getConnectionCount() > 0; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    assert(server->getConnectionCount() == 0);
+    for (int i = 0; i < client_count / 2; i++)
+        clients.push_back(connectLocal(reuse_port));
+    for (int i = 0; i < 2000 && server->getConnectionCount() < client_count / 2; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    assert(server->getConnectionCount() == client_count / 2);
+    std::atomic<int> visited(0);
+    server->forEachConnection([&](const rs_connection::Connection::ptr &)
+                              { visited++; });
+    for (int i = 0; i < 2000 && visited < client_count / 2; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    assert(visited == client_count / 2);
+
+    for (int fd : clients)
+        close(fd);
+
+    std::cout << "✓ 复用端口模式的监听套接字测试通过" << std::endl;
+}
+
+int main()
+{
+    std::cout << "开始连接获取测试...\n"
+              << std::endl;
+
+    testAcceptBudget();
+    testShedOnExhaustion();
+    testOneTaskPerBatch();
+    testReusePortListenOnStart();
+
+    std::cout << "\n🎉 所有测试通过！" << std::endl;
+
+    // 服务器线程中的事件循环不会退出，直接结束进程
+    std::cout.flush();
+    std::_Exit(0);
+}
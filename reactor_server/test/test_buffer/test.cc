@@ -4,6 +4,12 @@
 #include <string>
 #include <cstring>
 #include <algorithm>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/time.h>
 
 using namespace rs_buffer;
 
@@ -213,6 +219,119 @@ void testEdgeCases()
     std::cout << "✓ 边界情况测试通过" << std::endl;
 }
 
+void testReadv()
+{
+    std::cout << "测试分散读取..." << std::endl;
+
+    int fds[2];
+    assert(pipe(fds) == 0);
+
+    // 数据小于可写空间，直接读入缓冲区
+    Buffer buf;
+    char extra[4096];
+    const char *testData = "Hello Readv";
+    assert(write(fds[1], testData, strlen(testData)) == (ssize_t)strlen(testData));
+    assert(buf.readv_move(fds[0], extra, sizeof(extra)) == (ssize_t)strlen(testData));
+    assert(buf.getReadableSize() == strlen(testData));
+    assert(std::string(buf.getReadPos(), buf.getReadableSize()) == testData);
+
+    // 数据超出可写空间，超出部分经由额外缓冲区写入
+    std::string largeData(3000, 'R');
+    largeData.back() = 'E';
+    assert(write(fds[1], largeData.c_str(), largeData.size()) == (ssize_t)largeData.size());
+    assert(buf.readv_move(fds[0], extra, sizeof(extra)) == (ssize_t)largeData.size());
+    assert(buf.getReadableSize() == strlen(testData) + largeData.size());
+    assert(std::string(buf.getReadPos(), buf.getReadableSize()) == testData + largeData);
+
+    // 对端关闭返回-1
+    close(fds[1]);
+    assert(buf.readv_move(fds[0], extra, sizeof(extra)) == -1);
+    close(fds[0]);
+
+    std::cout << "✓ 分散读取测试通过" << std::endl;
+}
+
+static std::atomic<bool> alarm_fired(false);
+
+static void onAlarm(int)
+{
+    alarm_fired = true;
+}
+
+void testReadvInterrupted()
+{
+    std::cout << "测试分散读取被信号打断..." << std::endl;
+
+    // 不设置SA_RESTART，阻塞的readv被信号打断时返回EINTR
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onAlarm;
+    sigemptyset(&sa.sa_mask);
+    assert(sigaction(SIGALRM, &sa, nullptr) == 0);
+
+    int fds[2];
+    assert(pipe(fds) == 0);
+    const char *testData = "after signal";
+    std::thread writer([&]()
+                       {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        assert(write(fds[1], testData, strlen(testData)) == (ssize_t)strlen(testData)); });
+
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    timer.it_value.tv_usec = 50 * 1000;
+    assert(setitimer(ITIMER_REAL, &timer, nullptr) == 0);
+
+    // 被打断后重新读取，直到数据到达
+    Buffer buf;
+    char extra[4096];
+    assert(buf.readv_move(fds[0], extra, sizeof(extra)) == (ssize_t)strlen(testData));
+    assert(alarm_fired);
+    assert(std::string(buf.getReadPos(), buf.getReadableSize()) == testData);
+
+    writer.join();
+    close(fds[0]);
+    close(fds[1]);
+    signal(SIGALRM, SIG_DFL);
+
+    std::cout << "✓ 分散读取被信号打断测试通过" << std::endl;
+}
+
+void testLineFinder()
+{
+    std::cout << "测试行查找..." << std::endl;
+
+    Buffer buf;
+
+    // 不存在完整的一行
+    buf.write_move(std::string(100, 'a'), 100);
+    assert(buf.findLineEnd() == 0);
+    assert(buf.readLineView_noMove().empty());
+
+    // 换行符位于不同位置，覆盖向量化比较与逐字节比较
+    for (size_t len : {1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 200})
+    {
+        Buffer line_buf;
+        std::string line(len - 1, 'x');
+        line += '\n';
+        std::string data = line + "rest";
+        line_buf.write_move(data, data.size());
+        assert(line_buf.findLineEnd() == len);
+        assert(line_buf.readLineView_move() == line);
+        assert(line_buf.getReadableSize() == 4);
+    }
+
+    // 以第一个\n作为行结束，\r\n保留在行内
+    Buffer mixed;
+    const char *testData = "a\nb\r\n";
+    mixed.write_move((void *)testData, strlen(testData));
+    assert(mixed.readLineView_move() == "a\n");
+    assert(mixed.readLineView_move() == "b\r\n");
+    assert(mixed.getReadableSize() == 0);
+
+    std::cout << "✓ 行查找测试通过" << std::endl;
+}
+
 int main()
 {
     std::cout << "开始 Buffer 类功能测试...\n"
@@ -230,6 +349,9 @@ int main()
         testPointerMovement();
         testClearOperation();
         testEdgeCases();
+        testReadv();
+        testReadvInterrupted();
+        testLineFinder();
 
         std::cout << "\n🎉 所有测试通过！" << std::endl;
     }
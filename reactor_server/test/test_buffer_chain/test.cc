@@ -0,0 +1,227 @@
+#include <reactor_server/net/signal_ign.h>
+#include <reactor_server/net/buffer_chain.h>
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <memory>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+using namespace rs_buffer_chain;
+
+void testAppendAcrossSlabs()
+{
+    std::cout << "测试跨内存块追加..." << std::endl;
+
+    SlabPool pool;
+    BufferChain chain(&pool);
+    assert(chain.getReadableSize() == 0);
+
+    // 写入超过多个内存块大小的数据
+    std::string data(slab_size * 3 + 100, 'A');
+    chain.write_move(data, data.size());
+    assert(chain.getReadableSize() == data.size());
+
+    // 再追加少量数据，使用最后一个内存块的剩余空间
+    chain.write_move("tail", 4);
+    assert(chain.getReadableSize() == data.size() + 4);
+
+    chain.clear();
+    assert(chain.getReadableSize() == 0);
+
+    std::cout << "✓ 跨内存块追加测试通过" << std::endl;
+}
+
+void testWritev()
+{
+    std::cout << "测试writev发送..." << std::endl;
+
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL, 0) | O_NONBLOCK);
+
+    SlabPool pool;
+    BufferChain chain(&pool);
+
+    // 构造跨越多个内存块且内容可校验的数据
+    std::string data;
+    for (size_t i = 0; i < slab_size * 2 + 37; i++)
+        data += static_cast<char>('a' + i % 26);
+    chain.write_move(data, data.size());
+
+    // 一次writev发送多个内存块，对端接收后校验内容
+    std::string received;
+    while (chain.getReadableSize() > 0)
+    {
+        ssize_t ret = chain.writev_move(fds[0]);
+        assert(ret >= 0);
+
+        char buf[65536];
+        ssize_t n = recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT);
+        if (n > 0)
+            received.append(buf, n);
+    }
+    char buf[65536];
+    ssize_t n = 0;
+    while ((n = recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT)) > 0)
+        received.append(buf, n);
+    assert(received == data);
+
+    // 对端关闭后发送返回-1
+    close(fds[1]);
+    chain.write_move("x", 1);
+    assert(chain.writev_move(fds[0]) == -1);
+    close(fds[0]);
+
+    std::cout << "✓ writev发送测试通过" << std::endl;
+}
+
+void testSlabReuse()
+{
+    std::cout << "测试内存块复用..." << std::endl;
+
+    SlabPool pool;
+    BufferChain chain(&pool);
+
+    // 内存池中只有一个空闲内存块，写入时一定使用该内存块
+    char *slab = pool.allocate();
+    pool.deallocate(slab);
+    chain.write_move("hello", 5);
+    chain.moveReadPtr(5);
+    assert(chain.getReadableSize() == 0);
+    // 数据读完后内存块归还内存池，再次申请时得到的就是同一个内存块
+    char *freed = pool.allocate();
+    assert(freed == slab);
+    pool.deallocate(freed);
+
+    // 再次写入时复用归还的内存块
+    chain.write_move("world", 5);
+    chain.moveReadPtr(5);
+    freed = pool.allocate();
+    assert(freed == slab);
+    pool.deallocate(freed);
+
+    std::cout << "✓ 内存块复用测试通过" << std::endl;
+}
+
+void testFileRegion()
+{
+    std::cout << "测试文件区间发送..." << std::endl;
+
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL, 0) | O_NONBLOCK);
+
+    // 准备临时文件
+    char path[] = "/tmp/rs_buffer_chain_XXXXXX";
+    int file_fd = mkstemp(path);
+    assert(file_fd >= 0);
+    unlink(path);
+    std::string content;
+    for (size_t i = 0; i < slab_size + 123; i++)
+        content += static_cast<char>('0' + i % 10);
+    assert(write(file_fd, content.data(), content.size()) == static_cast<ssize_t>(content.size()));
+
+    SlabPool pool;
+    BufferChain chain(&pool);
+
+    // 文件区间前后都有普通数据，发送顺序与追加顺序一致
+    chain.write_move("head", 4);
+    chain.write_file(file_fd, 10, content.size() - 10);
+    chain.write_move("tail", 4);
+    assert(chain.getReadableSize() == content.size() - 10 + 8);
+
+    std::string received;
+    char buf[65536];
+    while (chain.getReadableSize() > 0)
+    {
+        ssize_t ret = chain.writev_move(fds[0]);
+        assert(ret >= 0);
+        ssize_t n = recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT);
+        if (n > 0)
+            received.append(buf, n);
+    }
+    ssize_t n = 0;
+    while ((n = recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT)) > 0)
+        received.append(buf, n);
+    assert(received == "head" + content.substr(10) + "tail");
+
+    // 文件区间发送完毕后文件描述符已经被关闭
+    assert(fcntl(file_fd, F_GETFD) == -1);
+
+    close(fds[0]);
+    close(fds[1]);
+
+    std::cout << "✓ 文件区间发送测试通过" << std::endl;
+}
+
+void testPayload()
+{
+    std::cout << "测试共享数据发送..." << std::endl;
+
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL, 0) | O_NONBLOCK);
+
+    SlabPool pool;
+    BufferChain chain(&pool);
+
+    std::string content;
+    for (size_t i = 0; i < slab_size + 321; i++)
+        content += static_cast<char>('A' + i % 26);
+    auto payload = std::make_shared<const std::string>(content);
+
+    // 共享数据前后都有普通数据，共享数据之后追加的数据写入新的内存块
+    chain.write_move("head", 4);
+    chain.write_payload(payload, 5);
+    chain.write_move("tail", 4);
+    assert(chain.getReadableSize() == content.size() - 5 + 8);
+    assert(payload.use_count() == 2);
+
+    std::string received;
+    char buf[65536];
+    while (chain.getReadableSize() > 0)
+    {
+        ssize_t ret = chain.writev_move(fds[0]);
+        assert(ret >= 0);
+        ssize_t n = recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT);
+        if (n > 0)
+            received.append(buf, n);
+    }
+    ssize_t n = 0;
+    while ((n = recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT)) > 0)
+        received.append(buf, n);
+    assert(received == "head" + content.substr(5) + "tail");
+    // 共享数据发送完毕后释放引用，数据本身没有被修改
+    assert(payload.use_count() == 1);
+    assert(*payload == content);
+
+    // 清理时同样释放引用
+    chain.write_payload(payload);
+    assert(payload.use_count() == 2);
+    chain.clear();
+    assert(payload.use_count() == 1);
+
+    close(fds[0]);
+    close(fds[1]);
+
+    std::cout << "✓ 共享数据发送测试通过" << std::endl;
+}
+
+int main()
+{
+    std::cout << "开始 BufferChain 类功能测试...\n"
+              << std::endl;
+
+    testAppendAcrossSlabs();
+    testWritev();
+    testSlabReuse();
+    testFileRegion();
+    testPayload();
+
+    std::cout << "\n🎉 所有测试通过！" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <reactor_server/net/loop_thread.h>
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+using namespace rs_event_loop_lock_queue;
+
+void sleepUs(int us)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+// 在事件循环线程中执行任务并等待执行完毕
+void runAndWait(EventLoopLockQueue *loop, const std::function<void()> &task)
+{
+    std::atomic<bool> done(false);
+    loop->runTasks([&]()
+                   {
+        task();
+        done = true; });
+    while (!done)
+        sleepUs(100);
+}
+
+void testBusyPoll(rs_poller::PollerType type, const std::string &name)
+{
+    std::cout << "测试" << name << "忙轮询..." << std::endl;
+
+    auto thread = new rs_loop_thread::LoopThread(TaskQueueType::Locked, type);
+    EventLoopLockQueue *loop = thread->getLoop();
+
+    // 未启用时不会忙轮询
+    runAndWait(loop, []() {});
+    assert(loop->getBusyPollHits() == 0 && loop->getBusyPollMisses() == 0);
+
+    // 忙轮询时间内到达的任务在忙轮询期间被处理
+    runAndWait(loop, [loop]()
+               { loop->enableBusyPoll(20000); });
+    uint64_t hits = loop->getBusyPollHits();
+    for (int i = 0; i < 20; i++)
+    {
+        runAndWait(loop, []() {});
+        sleepUs(1000);
+    }
+    assert(loop->getBusyPollHits() >= hits + 20);
+
+    // 空闲超过忙轮询时间后转为阻塞等待
+    uint64_t misses = loop->getBusyPollMisses();
+    sleepUs(50000);
+    assert(loop->getBusyPollMisses() > misses);
+
+    // 关闭之后计数不再变化
+    runAndWait(loop, [loop]()
+               { loop->enableBusyPoll(0); });
+    sleepUs(50000);
+    hits = loop->getBusyPollHits();
+    misses = loop->getBusyPollMisses();
+    runAndWait(loop, []() {});
+    sleepUs(50000);
+    assert(loop->getBusyPollHits() == hits && loop->getBusyPollMisses() == misses);
+
+    std::cout << "✓ " << name << "忙轮询测试通过" << std::endl;
+}
+
+int main()
+{
+    std::cout << "开始忙轮询测试...\n"
+              << std::endl;
+
+    testBusyPoll(rs_poller::PollerType::Epoll, "epoll");
+    testBusyPoll(rs_poller::PollerType::IoUring, "io_uring");
+
+    std::cout << "\n🎉 所有测试通过！" << std::endl;
+
+    // 从属线程中的事件循环不会退出，直接结束进程
+    std::cout.flush();
+    std::_Exit(0);
+}
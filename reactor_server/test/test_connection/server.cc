@@ -4,7 +4,6 @@
 #include <unistd.h>
 #include <algorithm>
 #include <reactor_server/base/log.h>
-#include <reactor_server/base/uuid_generator.h>
 #include <reactor_server/net/socket.h>
 #include <reactor_server/net/channel.h>
 #include <reactor_server/net/event_loop_lock_queue.h>
@@ -13,7 +12,9 @@
 using namespace rs_log_system;
 
 // 管理所有客户端连接的哈希表
-std::unordered_map<std::string, rs_connection::Connection::ptr> clients;
+std::unordered_map<uint64_t, rs_connection::Connection::ptr> clients;
+// 下一个连接ID
+uint64_t next_id = 0;
 
 void onConnected(const rs_connection::Connection::ptr &con);
 void onMessage(const rs_connection::Connection::ptr &con, rs_buffer::Buffer &buf);
@@ -24,7 +25,7 @@ void handleAccept(const rs_socket::Socket::ptr &socket, rs_event_loop_lock_queue
     // 获取新连接，并设置新连接的回调函数
     int newfd = socket->accept();
     // 创建客户端套接字结构
-    const std::string id = rs_uuid_generator::UuidGenerator::generate_uuid();
+    uint64_t id = ++next_id;
     rs_connection::Connection::ptr client = std::make_shared<rs_connection::Connection>(loop, id, newfd);
 
     client->enableTimeoutRelease(10);
@@ -0,0 +1,141 @@
+#include <reactor_server/net/loop_thread.h>
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+using namespace rs_event_loop_lock_queue;
+
+const int toggle_times = 50;
+
+// 在事件循环线程中执行任务并等待执行完毕
+void runAndWait(EventLoopLockQueue *loop, const std::function<void()> &task)
+{
+    std::atomic<bool> done(false);
+    loop->runTasks([&]()
+                   {
+        task();
+        done = true; });
+    while (!done)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+// 在一次任务中执行修改，再等待下一轮确保延迟的更新已经生效，返回期间的epoll_ctl调用次数
+uint64_t countCtl(EventLoopLockQueue *loop, const std::function<void()> &task)
+{
+    uint64_t before = loop->getEpollCtlCount();
+    runAndWait(loop, task);
+    runAndWait(loop, []() {});
+
+    return loop->getEpollCtlCount() - before;
+}
+
+void testToggleWrite(EventLoopLockQueue *loop, bool deferred)
+{
+    std::cout << "测试" << (deferred ? "延迟更新" : "直接更新") << "时切换写事件关心..." << std::endl;
+
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    rs_channel::Channel channel(loop, fds[0]);
+    assert(countCtl(loop, [&]()
+                    { channel.enableConcerningReadFd(); }) == 1);
+
+    // 重复设置相同的事件关心不调用epoll_ctl
+    assert(countCtl(loop, [&]()
+                    {
+        for (int i = 0; i < toggle_times; i++)
+            channel.enableConcerningReadFd(); }) == 0);
+
+    // 每次切换都生效，或者只生效本轮最终没有变化的结果
+    uint64_t count = countCtl(loop, [&]()
+                              {
+        for (int i = 0; i < toggle_times; i++)
+        {
+            channel.enableConcerningWriteFd();
+            channel.disableConcerningWriteFd();
+        } });
+    assert(count == (deferred ? 0 : 2 * toggle_times));
+
+    // 最终结果为启用写事件关心时延迟更新只调用一次
+    count = countCtl(loop, [&]()
+                     {
+        for (int i = 0; i < toggle_times; i++)
+        {
+            channel.disableConcerningWriteFd();
+            channel.enableConcerningWriteFd();
+        } });
+    assert(count == (deferred ? 1 : 2 * toggle_times - 1));
+    assert(countCtl(loop, [&]()
+                    { channel.disableConcerningWriteFd(); }) == 1);
+
+    assert(countCtl(loop, [&]()
+                    { channel.removeFd(); }) == 1);
+    close(fds[0]);
+    close(fds[1]);
+
+    std::cout << "✓ " << (deferred ? "延迟更新" : "直接更新") << "时切换写事件关心测试通过" << std::endl;
+}
+
+void testCtlFailure(EventLoopLockQueue *loop)
+{
+    std::cout << "测试epoll_ctl失败时的事件记录..." << std::endl;
+
+    // 普通文件不支持epoll，添加失败后保持未添加状态，下一次更新时重新添加
+    char path[] = "/tmp/rs_event_update_XXXXXX";
+    int file_fd = mkstemp(path);
+    assert(file_fd >= 0);
+    unlink(path);
+    rs_channel::Channel file_channel(loop, file_fd);
+    assert(countCtl(loop, [&]()
+                    { file_channel.enableConcerningReadFd(); }) == 1);
+    runAndWait(loop, [&]()
+               {
+        assert(!file_channel.isInPoller());
+        assert(file_channel.getAppliedEvents() == 0); });
+    assert(countCtl(loop, [&]()
+                    { file_channel.enableConcerningReadFd(); }) == 1);
+    close(file_fd);
+
+    // 描述符已经关闭时修改失败，保留原来生效的事件，再次修改时重新调用epoll_ctl
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    rs_channel::Channel channel(loop, fds[0]);
+    assert(countCtl(loop, [&]()
+                    { channel.enableConcerningReadFd(); }) == 1);
+    close(fds[0]);
+    assert(countCtl(loop, [&]()
+                    { channel.enableConcerningWriteFd(); }) == 1);
+    runAndWait(loop, [&]()
+               { assert(channel.getAppliedEvents() == EPOLLIN); });
+    assert(countCtl(loop, [&]()
+                    { channel.enableConcerningWriteFd(); }) == 1);
+    runAndWait(loop, [&]()
+               { channel.removeFd(); });
+    close(fds[1]);
+
+    std::cout << "✓ epoll_ctl失败时的事件记录测试通过" << std::endl;
+}
+
+int main()
+{
+    std::cout << "开始事件关心更新测试...\n"
+              << std::endl;
+
+    rs_loop_thread::LoopThread thread;
+    EventLoopLockQueue *loop = thread.getLoop();
+
+    testToggleWrite(loop, false);
+    testCtlFailure(loop);
+    loop->enableDeferredUpdate();
+    testToggleWrite(loop, true);
+
+    std::cout << "\n🎉 所有测试通过！" << std::endl;
+
+    // 从属线程中的事件循环不会退出，直接结束进程
+    std::cout.flush();
+    std::_Exit(0);
+}
@@ -0,0 +1,272 @@
+#include <reactor_server/net/signal_ign.h>
+#include <reactor_server/net/http/http_response.h>
+#include <reactor_server/net/http/utils/file_cache.h>
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+using namespace rs_file_cache;
+using namespace rs_buffer_chain;
+
+const std::string test_dir = "./test_file_cache_dir";
+
+void writeFile(const std::string &path, const std::string &content)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << content;
+}
+
+// 发送输出缓冲区中的全部数据并返回对端收到的内容
+std::string drain(BufferChain &chain)
+{
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL, 0) | O_NONBLOCK);
+
+    std::string received;
+    char buf[65536];
+    while (chain.getReadableSize() > 0)
+    {
+        assert(chain.writev_move(fds[0]) >= 0);
+        ssize_t n = recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT);
+        if (n > 0)
+            received.append(buf, n);
+    }
+    ssize_t n = 0;
+    while ((n = recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT)) > 0)
+        received.append(buf, n);
+
+    close(fds[0]);
+    close(fds[1]);
+    return received;
+}
+
+void testHitAndMiss()
+{
+    std::cout << "测试缓存命中..." << std::endl;
+
+    std::string path = test_dir + "/index.html";
+    writeFile(path, "<h1>hello</h1>");
+
+    FileCache cache;
+    auto file = cache.get(path, "text/html");
+    assert(file);
+    assert(*file->body == "<h1>hello</h1>");
+    assert(*file->headers == "Content-Type: text/html\r\nContent-Length: 14\r\n");
+    assert(cache.getMisses() == 1 && cache.getHits() == 0);
+
+    // 命中时返回同一份内容
+    auto again = cache.get(path, "text/html");
+    assert(again == file);
+    assert(cache.getHits() == 1);
+    assert(cache.getFileCount() == 1 && cache.getTotalBytes() == 14);
+
+    // 不存在的文件与目录不缓存
+    assert(!cache.get(test_dir + "/none.html", "text/html"));
+    assert(!cache.get(test_dir, "text/html"));
+    assert(cache.getFileCount() == 1);
+
+    std::cout << "✓ 缓存命中测试通过" << std::endl;
+}
+
+void testEviction()
+{
+    std::cout << "测试LRU淘汰..." << std::endl;
+
+    for (int i = 0; i < 4; i++)
+        writeFile(test_dir + "/" + std::to_string(i) + ".txt", std::string(100, 'a' + i));
+
+    // 总容量只能容纳3个文件
+    FileCache cache(300, 200);
+    assert(cache.get(test_dir + "/0.txt", "text/plain"));
+    assert(cache.get(test_dir + "/1.txt", "text/plain"));
+    assert(cache.get(test_dir + "/2.txt", "text/plain"));
+    // 访问0使1成为最近最少使用的文件
+    assert(cache.get(test_dir + "/0.txt", "text/plain"));
+    assert(cache.get(test_dir + "/3.txt", "text/plain"));
+    assert(cache.getFileCount() == 3 && cache.getTotalBytes() == 300);
+
+    uint64_t misses = cache.getMisses();
+    assert(cache.get(test_dir + "/0.txt", "text/plain"));
+    assert(cache.get(test_dir + "/3.txt", "text/plain"));
+    assert(cache.getMisses() == misses);
+    assert(cache.get(test_dir + "/1.txt", "text/plain"));
+    assert(cache.getMisses() == misses + 1);
+
+    // 超过单个文件大小上限的文件不缓存
+    writeFile(test_dir + "/big.txt", std::string(201, 'x'));
+    assert(!cache.get(test_dir + "/big.txt", "text/plain"));
+    assert(cache.getTotalBytes() == 300);
+
+    cache.clear();
+    assert(cache.getFileCount() == 0 && cache.getTotalBytes() == 0);
+
+    std::cout << "✓ LRU淘汰测试通过" << std::endl;
+}
+
+void testUncached()
+{
+    std::cout << "测试记录不缓存的路径..." << std::endl;
+
+    std::string missing = test_dir + "/missing.html";
+    std::string big = test_dir + "/large.txt";
+    unlink(missing.c_str());
+    writeFile(big, std::string(201, 'x'));
+
+    FileCache cache(300, 200);
+    cache.setCheckInterval(UINT64_MAX);
+    UncachedReason reason = UncachedReason::Unknown;
+    assert(!cache.get(missing, "text/html", &reason));
+    assert(reason == UncachedReason::NotRegular);
+    assert(!cache.get(test_dir, "text/html", &reason));
+    assert(reason == UncachedReason::NotRegular);
+    assert(!cache.get(big, "text/plain", &reason));
+    assert(reason == UncachedReason::TooLarge);
+    assert(cache.getMisses() == 3 && cache.getUncachedCount() == 3);
+
+    // 检查间隔内直接返回记录的原因，不再读取文件
+    reason = UncachedReason::Unknown;
+    assert(!cache.get(missing, "text/html", &reason));
+    assert(reason == UncachedReason::NotRegular);
+    assert(!cache.get(big, "text/plain", &reason));
+    assert(reason == UncachedReason::TooLarge);
+    assert(cache.getMisses() == 3 && cache.getUncachedHits() == 2);
+
+    // 文件状态没有变化时记录仍然有效
+    cache.setCheckInterval(0);
+    assert(!cache.get(big, "text/plain", &reason));
+    assert(reason == UncachedReason::TooLarge);
+    assert(cache.getMisses() == 3 && cache.getUncachedHits() == 3);
+
+    // 文件创建或者变小之后重新读取并缓存
+    writeFile(missing, "<p>new</p>");
+    writeFile(big, std::string(100, 'y'));
+    auto created = cache.get(missing, "text/html");
+    assert(created && *created->body == "<p>new</p>");
+    auto shrunk = cache.get(big, "text/plain");
+    assert(shrunk && shrunk->size == 100);
+    assert(cache.getMisses() == 5 && cache.getUncachedCount() == 1);
+
+    cache.clear();
+    assert(cache.getUncachedCount() == 0);
+
+    std::cout << "✓ 记录不缓存的路径测试通过" << std::endl;
+}
+
+void testNotifyInvalidate()
+{
+    std::cout << "测试inotify失效..." << std::endl;
+
+    std::string path = test_dir + "/notify.css";
+    writeFile(path, "body{}");
+
+    FileCache cache;
+    if (cache.getNotifyFd() < 0)
+    {
+        std::cout << "inotify不可用，跳过" << std::endl;
+        return;
+    }
+    // 有监控时不检查修改时间
+    cache.setCheckInterval(UINT64_MAX);
+    auto file = cache.get(path, "text/css");
+    assert(file && *file->body == "body{}");
+
+    writeFile(path, "body{color:red}");
+    cache.handleNotify();
+    assert(cache.getFileCount() == 0);
+
+    auto updated = cache.get(path, "text/css");
+    assert(updated && *updated->body == "body{color:red}");
+    // 旧的内容仍然可以被正在发送的响应使用
+    assert(*file->body == "body{}");
+
+    // 删除文件后缓存失效
+    unlink(path.c_str());
+    cache.handleNotify();
+    assert(cache.getFileCount() == 0);
+    assert(!cache.get(path, "text/css"));
+
+    std::cout << "✓ inotify失效测试通过" << std::endl;
+}
+
+void testMtimeInvalidate()
+{
+    std::cout << "测试修改时间检查..." << std::endl;
+
+    std::string path = test_dir + "/mtime.js";
+    writeFile(path, "var a = 1;");
+
+    // 只有没有inotify监控的文件才检查修改时间
+    FileCache cache;
+    if (cache.getNotifyFd() >= 0)
+    {
+        std::cout << "inotify可用，跳过" << std::endl;
+        return;
+    }
+    // 检查间隔为0时每次获取都检查修改时间
+    cache.setCheckInterval(0);
+    auto file = cache.get(path, "application/javascript");
+    assert(file);
+
+    writeFile(path, "var a = 12;");
+    auto updated = cache.get(path, "application/javascript");
+    assert(updated && *updated->body == "var a = 12;");
+    assert(cache.getMisses() == 2);
+
+    std::cout << "✓ 修改时间检查测试通过" << std::endl;
+}
+
+void testSerialize()
+{
+    std::cout << "测试缓存文件响应..." << std::endl;
+
+    std::string path = test_dir + "/page.html";
+    std::string content(rs_http_response::body_attach_threshold * 2, 'p');
+    writeFile(path, content);
+
+    FileCache cache;
+    auto file = cache.get(path, "text/html");
+    assert(file);
+
+    rs_http_request::HttpRequest req;
+    rs_http_response::HttpResponse resp;
+    resp.setCachedFile(file);
+    resp.setHeader("Connection", "keep-alive");
+    assert(resp.hasCachedFile());
+
+    std::string expected = resp.constructHttpResponseStr(req);
+    assert(expected.find("Content-Length: " + std::to_string(content.size()) + "\r\n") != std::string::npos);
+    assert(expected.compare(expected.size() - content.size() - 4, 4, "\r\n\r\n") == 0);
+
+    SlabPool pool;
+    BufferChain chain(&pool);
+    resp.serialize(chain, req.getVersion());
+    assert(drain(chain) == expected);
+
+    // 只发送响应头
+    resp.serialize(chain, req.getVersion(), false);
+    assert(drain(chain) == expected.substr(0, expected.size() - content.size()));
+
+    std::cout << "✓ 缓存文件响应测试通过" << std::endl;
+}
+
+int main()
+{
+    mkdir(test_dir.c_str(), 0755);
+
+    testHitAndMiss();
+    testEviction();
+    testUncached();
+    testNotifyInvalidate();
+    testMtimeInvalidate();
+    testSerialize();
+
+    std::filesystem::remove_all(test_dir);
+
+    std::cout << "\n🎉 所有测试通过！" << std::endl;
+    return 0;
+}
@@ -0,0 +1,155 @@
+/* HTTP请求解析吞吐测试：比较原有的正则表达式解析与状态机解析器，以及状态机解析器在分片输入下的表现 */
+// 操作：./bench [解析的请求数]
+
+#include <iostream>
+#include <chrono>
+#include <regex>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <reactor_server/net/http/http_context.h>
+#include <reactor_server/net/http/utils/common_op.h>
+
+using namespace rs_http_context;
+
+// 浏览器的典型请求
+const std::string request =
+    "GET /static/js/app.js?v=20240101&lang=zh-CN HTTP/1.1\r\n"
+    "Host: 127.0.0.1:8080\r\n"
+    "Connection: keep-alive\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36\r\n"
+    "Accept: */*\r\n"
+    "Referer: http://127.0.0.1:8080/index.html\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "Accept-Language: zh-CN,zh;q=0.9,en;q=0.8\r\n"
+    "Cookie: session=3f2a9c0d5e7b41a8; theme=dark\r\n"
+    "\r\n";
+
+// 原有的解析方式：每个请求行构造一次正则表达式，请求头逐行分割
+class LegacyContext
+{
+public:
+    bool parse(rs_buffer::Buffer &buf)
+    {
+        std::string line_str(buf.readLineView_noMove());
+        buf.moveReadPtr(line_str.size());
+        std::regex expr(
+            R"((GET|POST|PUT|DELETE|PATCH|HEAD|OPTIONS|TRACE|CONNECT) (/[^?]*)(?:\?(.*))* (HTTP/1.[01])(?:\r\n|\n)?)", std::regex::icase);
+        std::smatch matches;
+        if (!std::regex_match(line_str, matches, expr))
+            return false;
+
+        std::string method = matches[1].str();
+        std::transform(method.begin(), method.end(), method.begin(), ::toupper);
+        request_.setMethod(method);
+        std::string decode_path;
+        rs_url_op::UrlOp::urlDecode(decode_path, matches[2].str());
+        request_.setPath(decode_path);
+        request_.setVersion(matches[4].str());
+
+        std::vector<std::string> params;
+        rs_common_op::CommonOp::split(params, matches[3].str(), "&");
+        for (auto &str : params)
+        {
+            std::vector<std::string> out;
+            rs_common_op::CommonOp::split(out, str, "=");
+            if (out.size() >= 2)
+            {
+                std::string key, value;
+                rs_url_op::UrlOp::urlDecode(key, out[0]);
+                rs_url_op::UrlOp::urlDecode(value, out[1]);
+                request_.setParam(key, value);
+            }
+        }
+
+        while (true)
+        {
+            std::string_view line = buf.readLineView_noMove();
+            if (line.size() == 0)
+                return false;
+            buf.moveReadPtr(line.size());
+            if (line == "\r\n" || line == "\n")
+                break;
+            if (line.back() == '\n')
+                line.remove_suffix(1);
+            if (line.back() == '\r')
+                line.remove_suffix(1);
+            std::vector<std::string> key_value;
+            rs_common_op::CommonOp::split(key_value, line, ": ");
+            if (key_value.size() == 2)
+                request_.setHeader(key_value[0], key_value[1]);
+        }
+
+        return true;
+    }
+
+    void clear()
+    {
+        request_.clear();
+    }
+
+private:
+    rs_http_request::HttpRequest request_;
+};
+
+// 返回每秒解析的请求数
+double benchLegacy(size_t count)
+{
+    LegacyContext context;
+    rs_buffer::Buffer buf;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++)
+    {
+        buf.write_move(request, request.size());
+        bool ret = context.parse(buf);
+        if (!ret)
+            std::abort();
+        context.clear();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return count / seconds;
+}
+
+// chunk为0时一次写入整个请求，否则每次写入chunk字节后解析一次
+double benchParser(size_t count, size_t chunk)
+{
+    HttpContext context;
+    rs_buffer::Buffer buf;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t step = chunk == 0 ? request.size() : chunk;
+        for (size_t pos = 0; pos < request.size(); pos += step)
+        {
+            buf.write_move((void *)(request.data() + pos), std::min(step, request.size() - pos));
+            context.constructHttpRequest(buf);
+        }
+        if (context.getRecvStatus() != ReqRecvStatus::RecvOk)
+            std::abort();
+        context.clear();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return count / seconds;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+    double legacy = benchLegacy(count / 10);
+    double parser = benchParser(count, 0);
+    double parser_chunk = benchParser(count, 64);
+
+    std::printf("request size: %zu bytes\n", request.size());
+    std::printf("%-24s %16s\n", "parser", "requests/s");
+    std::printf("%-24s %16.0f\n", "regex (legacy)", legacy);
+    std::printf("%-24s %16.0f  (%.1fx)\n", "state machine", parser, parser / legacy);
+    std::printf("%-24s %16.0f  (%.1fx)\n", "state machine, 64B reads", parser_chunk, parser_chunk / legacy);
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include <reactor_server/net/http/http_context.h>
+#include <iostream>
+#include <cassert>
+#include <string>
+
+using namespace rs_http_parser;
+using namespace rs_http_context;
+
+const std::string simple_request =
+    "GET /index%20page.html?name=%E5%BC%A0%E4%B8%89&age=18&empty=&=x HTTP/1.1\r\n"
+    "Host: 127.0.0.1:8080\r\n"
+    "Connection:   keep-alive  \r\n"
+    "Accept: text/html, */*; q=0.8\r\n"
+    "\r\n";
+
+void testParser()
+{
+    std::cout << "测试解析器..." << std::endl;
+
+    HttpParser parser;
+    const char *data = simple_request.data();
+    assert(parser.parse(data, simple_request.size()) == ParseStatus::Complete);
+    assert(parser.getHeadLength() == simple_request.size());
+    assert(parser.getMethod().toView(data) == "GET");
+    assert(parser.getPath().toView(data) == "/index%20page.html");
+    assert(parser.getQuery().toView(data) == "name=%E5%BC%A0%E4%B8%89&age=18&empty=&=x");
+    assert(parser.getVersion().toView(data) == "HTTP/1.1");
+
+    auto &headers = parser.getHeaders();
+    assert(headers.size() == 3);
+    assert(headers[0].name.toView(data) == "Host");
+    assert(headers[0].value.toView(data) == "127.0.0.1:8080");
+    // 字段值去除首尾空白，内部的冒号与空格保留
+    assert(headers[1].value.toView(data) == "keep-alive");
+    assert(headers[2].value.toView(data) == "text/html, */*; q=0.8");
+
+    std::cout << "✓ 解析器测试通过" << std::endl;
+}
+
+void testIncremental()
+{
+    std::cout << "测试逐字节输入..." << std::endl;
+
+    // 每次只多给一个字节，前面的数据保持不变
+    HttpParser parser;
+    for (size_t i = 1; i < simple_request.size(); i++)
+        assert(parser.parse(simple_request.data(), i) == ParseStatus::Partial);
+    assert(parser.parse(simple_request.data(), simple_request.size()) == ParseStatus::Complete);
+    assert(parser.getHeaders().size() == 3);
+    assert(parser.getHeaders()[1].value.toView(simple_request.data()) == "keep-alive");
+
+    // 通过上下文分多次写入缓冲区
+    HttpContext context;
+    rs_buffer::Buffer buf;
+    for (size_t i = 0; i < simple_request.size(); i += 7)
+    {
+        std::string part = simple_request.substr(i, 7);
+        buf.write_move(part, part.size());
+        context.constructHttpRequest(buf);
+        if (i + 7 < simple_request.size())
+            assert(context.getRecvStatus() == ReqRecvStatus::RecvLine || context.getRecvStatus() == ReqRecvStatus::RecvHeader);
+    }
+    assert(context.getRecvStatus() == ReqRecvStatus::RecvOk);
+    assert(buf.getReadableSize() == 0);
+
+    auto &req = context.getRequest();
+    assert(req.getMethod() == "GET");
+    assert(req.getPath() == "/index page.html");
+    assert(req.getVersion() == "HTTP/1.1");
+    assert(req.getParam("name") == "张三");
+    assert(req.getParam("age") == "18");
+    assert(!req.isInParams("empty"));
+    assert(req.getHeader("Host") == "127.0.0.1:8080");
+    assert(req.isKeepAlive());
+
+    std::cout << "✓ 逐字节输入测试通过" << std::endl;
+}
+
+void testPipelineAndBody()
+{
+    std::cout << "测试请求体与流水线请求..." << std::endl;
+
+    std::string data =
+        "\r\npost /submit HTTP/1.0\n"
+        "Content-Length: 5\n"
+        "\n"
+        "hello"
+        "GET / HTTP/1.1\r\n\r\n";
+
+    HttpContext context;
+    rs_buffer::Buffer buf;
+    buf.write_move(data, data.size());
+
+    context.constructHttpRequest(buf);
+    assert(context.getRecvStatus() == ReqRecvStatus::RecvOk);
+    assert(context.getRequest().getMethod() == "POST");
+    assert(context.getRequest().getVersion() == "HTTP/1.0");
+    assert(context.getRequest().getBody() == "hello");
+    context.clear();
+
+    context.constructHttpRequest(buf);
+    assert(context.getRecvStatus() == ReqRecvStatus::RecvOk);
+    assert(context.getRequest().getPath() == "/");
+    assert(buf.getReadableSize() == 0);
+
+    std::cout << "✓ 请求体与流水线请求测试通过" << std::endl;
+}
+
+int parseError(const std::string &data)
+{
+    HttpContext context;
+    rs_buffer::Buffer buf;
+    buf.write_move(data, data.size());
+    context.constructHttpRequest(buf);
+    if (context.getRecvStatus() != ReqRecvStatus::RecvError)
+        return 0;
+    return context.getResponseStatus();
+}
+
+void testErrors()
+{
+    std::cout << "测试错误请求..." << std::endl;
+
+    assert(parseError("GET index.html HTTP/1.1\r\n\r\n") == 400);
+    assert(parseError("G3T / HTTP/1.1\r\n\r\n") == 400);
+    assert(parseError("GET / HTTP/2.0\r\n\r\n") == 400);
+    assert(parseError("GET / HTTP/1.1\rX\n\r\n") == 400);
+    assert(parseError("GET / HTTP/1.1\r\nHost : a\r\n\r\n") == 400);
+    assert(parseError("GET / HTTP/1.1\r\n: a\r\n\r\n") == 400);
+    assert(parseError("GET / HTTP/1.1\r\nHost\r\n\r\n") == 400);
+
+    // 请求行过长，即使没有收到换行也能够发现
+    assert(parseError("GET /" + std::string(rs_http_parser::max_line_size, 'a')) == 414);
+    assert(parseError("GET /" + std::string(rs_http_parser::max_line_size, 'a') + " HTTP/1.1\r\n\r\n") == 414);
+    assert(parseError("GET / HTTP/1.1\r\nX: " + std::string(rs_http_parser::max_line_size, 'a')) == 431);
+
+    std::string many = "GET / HTTP/1.1\r\n";
+    for (size_t i = 0; i <= rs_http_parser::max_header_count; i++)
+        many += "X-" + std::to_string(i) + ": 1\r\n";
+    assert(parseError(many + "\r\n") == 431);
+
+    std::cout << "✓ 错误请求测试通过" << std::endl;
+}
+
+int main()
+{
+    testParser();
+    testIncremental();
+    testPipelineAndBody();
+    testErrors();
+
+    std::cout << "\n🎉 所有测试通过！" << std::endl;
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include <reactor_server/net/http/http_context.h>
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <string>
+
+using namespace rs_http_request;
+using namespace rs_http_context;
+
+// 统计堆内存申请次数，通过sanitizer运行时的分配钩子计数，内存仍由默认的分配器管理
+// 没有链接sanitizer运行时时该函数为空，不统计
+extern "C" int __sanitizer_install_malloc_and_free_hooks(void (*malloc_hook)(const volatile void *, size_t),
+                                                         void (*free_hook)(const volatile void *)) __attribute__((weak));
+
+static std::atomic<size_t> alloc_count(0);
+
+static void countMalloc(const volatile void *, size_t)
+{
+    alloc_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void ignoreFree(const volatile void *)
+{
+}
+
+static bool installAllocHooks()
+{
+    return __sanitizer_install_malloc_and_free_hooks != nullptr &&
+           __sanitizer_install_malloc_and_free_hooks(countMalloc, ignoreFree) != 0;
+}
+
+void testFieldTable()
+{
+    std::cout << "测试字段表..." << std::endl;
+
+    FieldTable headers(true);
+    for (int i = 0; i < 40; i++)
+        headers.add("X-Field-" + std::to_string(i), std::to_string(i));
+    assert(headers.size() == 40);
+    // 超过内联个数的字段同样可以查找
+    assert(headers.getValue(headers.find("x-field-3")) == "3");
+    assert(headers.getValue(headers.find("X-FIELD-39")) == "39");
+    assert(headers.find("X-Field-40") == npos);
+
+    // 同名字段以最后添加的为准
+    headers.add("x-field-3", "new");
+    assert(headers.getValue(headers.find("X-Field-3")) == "new");
+
+    // 区分大小写的字段表
+    FieldTable params(false);
+    params.add("Key", "1");
+    assert(params.find("key") == npos);
+    assert(params.getValue(params.find("Key")) == "1");
+
+    // 拷贝后字段依旧有效
+    FieldTable copy = headers;
+    headers.clear();
+    assert(headers.size() == 0);
+    assert(copy.getValue(copy.find("x-field-10")) == "10");
+
+    std::cout << "✓ 字段表测试通过" << std::endl;
+}
+
+void testCachedHeaders()
+{
+    std::cout << "测试常用请求头缓存..." << std::endl;
+
+    HttpRequest req;
+    assert(req.getContentLength() == 0);
+    assert(!req.isKeepAlive());
+
+    req.setHeader("host", "example.com");
+    req.setHeader("content-length", "1024");
+    req.setHeader("CONNECTION", "Keep-Alive");
+    req.setHeader("Transfer-Encoding", "chunked");
+    assert(req.getHost() == "example.com");
+    assert(req.getContentLength() == 1024);
+    assert(req.isContentLengthValid());
+    assert(req.isKeepAlive());
+    assert(req.getTransferEncoding() == "chunked");
+    assert(req.getHeader("Content-Length") == "1024");
+
+    req.setHeader("Connection", "close");
+    assert(!req.isKeepAlive());
+    req.setHeader("Content-Length", "12abc");
+    assert(!req.isContentLengthValid());
+    assert(req.getContentLength() == 0);
+
+    req.clear();
+    assert(req.isContentLengthValid());
+    assert(req.getHost().empty());
+    assert(!req.isInHeaders("Host"));
+
+    std::cout << "✓ 常用请求头缓存测试通过" << std::endl;
+}
+
+void testContext()
+{
+    std::cout << "测试请求解析..." << std::endl;
+
+    std::string bad = "POST / HTTP/1.1\r\nContent-Length: -1\r\n\r\n";
+    HttpContext bad_context;
+    rs_buffer::Buffer bad_buf;
+    bad_buf.write_move(bad, bad.size());
+    bad_context.constructHttpRequest(bad_buf);
+    assert(bad_context.getRecvStatus() == ReqRecvStatus::RecvError);
+    assert(bad_context.getResponseStatus() == 400);
+
+    std::string request =
+        "GET /index.html?a=1&b=2 HTTP/1.1\r\n"
+        "Host: 127.0.0.1:8080\r\n"
+        "Connection: keep-alive\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+        "Accept-Encoding: gzip, deflate, br\r\n"
+        "Accept-Language: zh-CN,zh;q=0.9,en;q=0.8\r\n"
+        "Content-Length: 5\r\n"
+        "\r\n"
+        "hello";
+
+    bool installed = installAllocHooks();
+    HttpContext context;
+    rs_buffer::Buffer buf;
+    size_t steady = 0;
+    for (int i = 0; i < 10; i++)
+    {
+        buf.write_move(request, request.size());
+        size_t before = alloc_count;
+        context.constructHttpRequest(buf);
+        assert(context.getRecvStatus() == ReqRecvStatus::RecvOk);
+        auto &req = context.getRequest();
+        assert(req.isKeepAlive());
+        assert(req.getContentLength() == 5);
+        assert(req.getHost() == "127.0.0.1:8080");
+        assert(req.getParamView("b") == "2");
+        assert(req.getHeaderView("accept-encoding") == "gzip, deflate, br");
+        assert(req.getBody() == "hello");
+        context.clear();
+        steady = alloc_count - before;
+    }
+    // 同一个上下文复用后，除了请求路径外不再申请内存
+    if (installed)
+    {
+        std::cout << "复用上下文时单个请求的内存申请次数：" << steady << std::endl;
+        assert(steady <= 2);
+    }
+    else
+    {
+        std::cout << "没有sanitizer运行时，跳过内存申请次数检查" << std::endl;
+    }
+
+    std::cout << "✓ 请求解析测试通过" << std::endl;
+}
+
+int main()
+{
+    testFieldTable();
+    testCachedHeaders();
+    testContext();
+
+    std::cout << "\n🎉 所有测试通过！" << std::endl;
+    return 0;
+}
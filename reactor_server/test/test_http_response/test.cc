@@ -0,0 +1,93 @@
+#include <reactor_server/net/signal_ign.h>
+#include <reactor_server/net/http/http_response.h>
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+using namespace rs_http_response;
+using namespace rs_buffer_chain;
+
+// 发送输出缓冲区中的全部数据并返回对端收到的内容
+std::string drain(BufferChain &chain)
+{
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL, 0) | O_NONBLOCK);
+
+    std::string received;
+    char buf[65536];
+    while (chain.getReadableSize() > 0)
+    {
+        assert(chain.writev_move(fds[0]) >= 0);
+        ssize_t n = recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT);
+        if (n > 0)
+            received.append(buf, n);
+    }
+    ssize_t n = 0;
+    while ((n = recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT)) > 0)
+        received.append(buf, n);
+
+    close(fds[0]);
+    close(fds[1]);
+    return received;
+}
+
+void testStatusLine()
+{
+    std::cout << "测试状态行..." << std::endl;
+
+    assert(rs_info_get::InfoGet::getStatusLine(200) == " 200 OK\r\n");
+    assert(rs_info_get::InfoGet::getStatusLine(404) == " 404 Not Found\r\n");
+    // 同一个状态码返回同一个预先生成的字符串
+    assert(&rs_info_get::InfoGet::getStatusLine(200) == &rs_info_get::InfoGet::getStatusLine(200));
+    assert(rs_info_get::InfoGet::getStatusLine(999) == " 999 none\r\n");
+
+    std::cout << "✓ 状态行测试通过" << std::endl;
+}
+
+void testSerialize()
+{
+    std::cout << "测试响应序列化..." << std::endl;
+
+    rs_http_request::HttpRequest req;
+    SlabPool pool;
+
+    // 较小的正文直接拷贝，结果与响应字符串一致
+    HttpResponse small(201);
+    small.setBody("hello", "text/plain");
+    small.setHeader("Content-Length", "5");
+    std::string expected = small.constructHttpResponseStr(req);
+    assert(expected.compare(0, 22, "HTTP/1.1 201 Created\r\n") == 0);
+    assert(expected.find("Content-Type: text/plain\r\n") != std::string::npos);
+    assert(expected.size() >= 9 && expected.compare(expected.size() - 9, 9, "\r\n\r\nhello") == 0);
+
+    BufferChain chain(&pool);
+    small.serialize(chain, req.getVersion());
+    assert(drain(chain) == expected);
+    assert(small.getBody() == "hello");
+
+    // 较大的正文转移所有权挂到输出缓冲区
+    std::string body(body_attach_threshold * 3 + 7, 'x');
+    HttpResponse big;
+    big.setBody(body);
+    expected = big.constructHttpResponseStr(req);
+    big.serialize(chain, "HTTP/1.0");
+    assert(big.getBody().empty());
+    std::string received = drain(chain);
+    assert(received.compare(0, 17, "HTTP/1.0 200 OK\r\n") == 0);
+    assert(received.substr(8) == expected.substr(8));
+
+    std::cout << "✓ 响应序列化测试通过" << std::endl;
+}
+
+int main()
+{
+    testStatusLine();
+    testSerialize();
+
+    std::cout << "\n🎉 所有测试通过！" << std::endl;
+    return 0;
+}
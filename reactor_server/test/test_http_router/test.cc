@@ -0,0 +1,167 @@
+#include <reactor_server/net/http/http_router.h>
+#include <iostream>
+#include <cassert>
+#include <string>
+
+using namespace rs_http_router;
+using namespace rs_http_request;
+using namespace rs_http_response;
+
+// 处理函数将自己的名称写入响应正文
+handler_t named(const std::string &name)
+{
+    return [name](HttpRequest &, HttpResponse &resp)
+    { resp.setBody(name); };
+}
+
+// 返回匹配到的处理函数名称，没有匹配时返回空字符串
+std::string dispatch(Router &router, const std::string &path, HttpRequest &req)
+{
+    req.clear();
+    req.setPath(path);
+    HttpResponse resp;
+    if (!router.route(req, resp))
+        return "";
+    return resp.getBody();
+}
+
+void testStaticAndParams()
+{
+    std::cout << "测试静态段与参数段..." << std::endl;
+
+    Router router;
+    assert(router.addRoute("/", named("root")));
+    assert(router.addRoute("/users", named("users")));
+    assert(router.addRoute("/users/list", named("list")));
+    assert(router.addRoute("/users/:id", named("user")));
+    assert(router.addRoute("/users/:id/posts/:post", named("post")));
+    assert(router.getRouteCount() == 5);
+
+    HttpRequest req;
+    assert(dispatch(router, "/", req) == "root");
+    assert(dispatch(router, "/users", req) == "users");
+    // 静态段优先于参数段
+    assert(dispatch(router, "/users/list", req) == "list");
+    assert(!req.isInPathParams("id"));
+
+    assert(dispatch(router, "/users/42", req) == "user");
+    assert(req.getPathParam("id") == "42");
+    assert(dispatch(router, "/users/42/posts/7", req) == "post");
+    assert(req.getPathParam("id") == "42");
+    assert(req.getPathParam("post") == "7");
+
+    // 尾部的/有意义，参数段不匹配空段
+    assert(dispatch(router, "/users/", req) == "");
+    assert(dispatch(router, "/users/42/posts", req) == "");
+    assert(dispatch(router, "/nope", req) == "");
+
+    std::cout << "✓ 静态段与参数段测试通过" << std::endl;
+}
+
+void testWildcardAndBacktrack()
+{
+    std::cout << "测试通配段与回溯..." << std::endl;
+
+    Router router;
+    assert(router.addRoute("/static/*path", named("static")));
+    assert(router.addRoute("/static/css/main.css", named("css")));
+    assert(router.addRoute("/api/:version/health", named("health")));
+    assert(router.addRoute("/api/v1/users", named("v1users")));
+    assert(router.addRoute("/files/*", named("files")));
+
+    HttpRequest req;
+    assert(dispatch(router, "/static/css/main.css", req) == "css");
+    assert(dispatch(router, "/static/css/other.css", req) == "static");
+    assert(req.getPathParam("path") == "css/other.css");
+    assert(dispatch(router, "/static/", req) == "static");
+    assert(req.isInPathParams("path") && req.getPathParam("path").empty());
+    assert(dispatch(router, "/static", req) == "");
+    assert(dispatch(router, "/files/a/b", req) == "files");
+    assert(req.getPathParam("*") == "a/b");
+
+    // 静态段v1不能匹配剩余路径时回溯到参数段，失败分支不留下参数
+    assert(dispatch(router, "/api/v1/health", req) == "health");
+    assert(req.getPathParam("version") == "v1");
+    assert(dispatch(router, "/api/v1/users", req) == "v1users");
+    assert(!req.isInPathParams("version"));
+
+    std::cout << "✓ 通配段与回溯测试通过" << std::endl;
+}
+
+void testInvalidRoutes()
+{
+    std::cout << "测试非法路由..." << std::endl;
+
+    Router router;
+    assert(!router.addRoute("users", named("x")));
+    assert(!router.addRoute("/a/*rest/b", named("x")));
+    assert(!router.addRoute("/a/:", named("x")));
+    assert(router.addRoute("/a/:id", named("a")));
+    assert(!router.addRoute("/a/:name/b", named("x")));
+    assert(router.addRoute("/a/:id/b", named("ab")));
+    // 重复添加时使用新的处理函数
+    assert(router.addRoute("/a/:id", named("a2")));
+    assert(router.getRouteCount() == 2);
+
+    HttpRequest req;
+    assert(dispatch(router, "/a/1", req) == "a2");
+    assert(dispatch(router, "/a/1/b", req) == "ab");
+
+    std::cout << "✓ 非法路由测试通过" << std::endl;
+}
+
+void testRegexFallback()
+{
+    std::cout << "测试正则表达式路由..." << std::endl;
+
+    Router router;
+    // 不含特殊字符的正则表达式直接加入前缀树
+    router.addRegexRoute("/get", named("get"));
+    router.addRegexRoute("/numbers/(\\d+)", named("numbers"));
+    router.addRegexRoute("/index.html", named("index"));
+    router.addRoute("/numbers/zero", named("zero"));
+    assert(router.getRouteCount() == 2);
+    assert(router.getRegexRouteCount() == 2);
+
+    HttpRequest req;
+    assert(dispatch(router, "/get", req) == "get");
+    assert(dispatch(router, "/get/", req) == "");
+    assert(dispatch(router, "/numbers/123", req) == "numbers");
+    // 前缀树路由优先于正则表达式路由
+    assert(dispatch(router, "/numbers/zero", req) == "zero");
+    assert(dispatch(router, "/numbers/abc", req) == "");
+    // 含有.的正则表达式保持原有语义
+    assert(dispatch(router, "/indexXhtml", req) == "index");
+
+    // 之前添加的正则表达式路由可以匹配时，之后不含特殊字符的路由不会越过它
+    Router ordered;
+    ordered.addRegexRoute("/first", named("first"));
+    ordered.addRegexRoute("/api/.*", named("catch_all"));
+    ordered.addRegexRoute("/api/health", named("health"));
+    ordered.addRegexRoute("/first", named("duplicate"));
+    assert(ordered.getRouteCount() == 1);
+    assert(ordered.getRegexRouteCount() == 3);
+    assert(dispatch(ordered, "/api/health", req) == "catch_all");
+    assert(dispatch(ordered, "/first", req) == "first");
+
+    // 正则表达式中的:没有特殊含义，只匹配自身，不会变成参数段
+    Router literal;
+    literal.addRegexRoute("/users/:id", named("literal"));
+    assert(literal.getRouteCount() == 0);
+    assert(literal.getRegexRouteCount() == 1);
+    assert(dispatch(literal, "/users/:id", req) == "literal");
+    assert(dispatch(literal, "/users/42", req) == "");
+
+    std::cout << "✓ 正则表达式路由测试通过" << std::endl;
+}
+
+int main()
+{
+    testStaticAndParams();
+    testWildcardAndBacktrack();
+    testInvalidRoutes();
+    testRegexFallback();
+
+    std::cout << "\n🎉 所有测试通过！" << std::endl;
+    return 0;
+}
@@ -0,0 +1,283 @@
+#include <reactor_server/net/loop_thread.h>
+#include <reactor_server/net/acceptor.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+using namespace rs_event_loop_lock_queue;
+
+// 在事件循环线程中执行任务并等待执行完毕
+void runAndWait(EventLoopLockQueue *loop, const std::function<void()> &task)
+{
+    std::atomic<bool> done(false);
+    loop->runTasks([&]()
+                   {
+        task();
+        done = true; });
+    while (!done)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+void sleepMs(int ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void testWakeupAndTimer(EventLoopLockQueue *loop)
+{
+    std::cout << "测试跨线程任务与定时任务..." << std::endl;
+
+    // 跨线程任务通过事件通知描述符唤醒事件循环
+    for (int i = 0; i < 100; i++)
+        runAndWait(loop, []() {});
+
+    // 定时任务通过定时器描述符触发
+    std::atomic<bool> fired(false);
+    runAndWait(loop, [&]()
+               { loop->insertTask(std::chrono::milliseconds(20), [&]()
+                                  { fired = true; }); });
+    sleepMs(200);
+    assert(fired);
+
+    std::cout << "✓ 跨线程任务与定时任务测试通过" << std::endl;
+}
+
+void testLevelTriggered(EventLoopLockQueue *loop)
+{
+    std::cout << "测试水平触发读事件..." << std::endl;
+
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    rs_channel::Channel channel(loop, fds[0]);
+    std::atomic<int> count(0);
+    channel.setReadCallback([&]()
+                            { count++; });
+    runAndWait(loop, [&]()
+               { channel.enableConcerningReadFd(); });
+
+    // 数据没有被读取时每一轮都会通知
+    assert(write(fds[1], "x", 1) == 1);
+    sleepMs(50);
+    assert(count > 1);
+
+    // 读取数据后不再通知
+    runAndWait(loop, [&]()
+               {
+        char buf[16];
+        assert(read(fds[0], buf, sizeof(buf)) == 1);
+        count = 0; });
+    sleepMs(50);
+    assert(count == 0);
+
+    // 修改关心的事件后只按照新的事件通知
+    runAndWait(loop, [&]()
+               { channel.disableConcerningReadFd(); });
+    assert(write(fds[1], "y", 1) == 1);
+    sleepMs(50);
+    assert(count == 0);
+    runAndWait(loop, [&]()
+               { channel.enableConcerningReadFd(); });
+    sleepMs(50);
+    assert(count > 0);
+
+    // 移除之后不再通知
+    runAndWait(loop, [&]()
+               { channel.removeFd(); });
+    count = 0;
+    sleepMs(50);
+    assert(count == 0);
+
+    close(fds[0]);
+    close(fds[1]);
+
+    std::cout << "✓ 水平触发读事件测试通过" << std::endl;
+}
+
+void testEdgeTriggered(EventLoopLockQueue *loop)
+{
+    std::cout << "测试边缘触发读事件..." << std::endl;
+
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    rs_channel::Channel channel(loop, fds[0]);
+    std::atomic<int> count(0);
+    channel.setReadCallback([&]()
+                            { count++; });
+    runAndWait(loop, [&]()
+               {
+        channel.enableEdgeTriggered();
+        channel.enableConcerningReadFd(); });
+
+    // 数据没有被读取时只通知一次，有新数据到达时再次通知
+    assert(write(fds[1], "x", 1) == 1);
+    sleepMs(50);
+    assert(count == 1);
+    assert(write(fds[1], "y", 1) == 1);
+    sleepMs(50);
+    assert(count == 2);
+
+    runAndWait(loop, [&]()
+               { channel.removeFd(); });
+    close(fds[0]);
+    close(fds[1]);
+
+    std::cout << "✓ 边缘触发读事件测试通过" << std::endl;
+}
+
+void testRecvCompletion(EventLoopLockQueue *loop)
+{
+    std::cout << "测试接收请求完成结果..." << std::endl;
+
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    rs_channel::Channel channel(loop, fds[0]);
+    channel.enableCompletion(rs_channel::CompletionOp::Recv);
+    std::string received;
+    std::atomic<size_t> received_size(0);
+    std::atomic<bool> eof(false);
+    channel.setReadCallback([&]()
+                            {
+        for (const rs_channel::Completion &c : channel.getCompletions())
+        {
+            if (c.res <= 0)
+            {
+                eof = true;
+                continue;
+            }
+            received.append(c.data, c.res);
+        }
+        received_size = received.size(); });
+    runAndWait(loop, [&]()
+               { channel.enableConcerningReadFd(); });
+
+    // 发送总量超过缓冲区环的容量，缓冲区没有归还时接收请求会因为缓冲区耗尽而停止，发送超时
+    struct timeval send_timeout = {2, 0};
+    assert(setsockopt(fds[1], SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout)) == 0);
+    const size_t chunk = 64 * 1024;
+    const size_t total = 8 * 1024 * 1024;
+    std::string data(chunk, '\0');
+    for (size_t sent = 0; sent < total; sent += chunk)
+    {
+        for (size_t i = 0; i < chunk; i++)
+            data[i] = static_cast<char>('a' + (sent + i) % 26);
+        assert(write(fds[1], data.data(), chunk) == static_cast<ssize_t>(chunk));
+    }
+    for (int i = 0; i < 2000 && received_size < total; i++)
+        sleepMs(1);
+    assert(received_size == total);
+    runAndWait(loop, [&]()
+               {
+        for (size_t i = 0; i < total; i++)
+            assert(received[i] == static_cast<char>('a' + i % 26));
+        received.clear();
+        received_size = 0; });
+
+    // 取消关心可读事件时取消接收请求，重新关心后继续接收
+    runAndWait(loop, [&]()
+               { channel.disableConcerningReadFd(); });
+    assert(write(fds[1], "z", 1) == 1);
+    sleepMs(50);
+    assert(received_size == 0);
+    runAndWait(loop, [&]()
+               { channel.enableConcerningReadFd(); });
+    sleepMs(50);
+    assert(received_size == 1);
+
+    // 对端关闭时得到结果为0的完成结果
+    close(fds[1]);
+    sleepMs(50);
+    assert(eof);
+
+    runAndWait(loop, [&]()
+               { channel.removeFd(); });
+    close(fds[0]);
+
+    std::cout << "✓ 接收请求完成结果测试通过" << std::endl;
+}
+
+void testAcceptCompletion(EventLoopLockQueue *loop)
+{
+    std::cout << "测试获取连接请求完成结果..." << std::endl;
+
+    const int port = 18241;
+    const int clients = 8;
+    // 监听套接字在进程结束前保持监控
+    static rs_acceptor::Acceptor::ptr acceptor;
+    std::vector<int> accepted;
+    std::atomic<int> accepted_count(0);
+    runAndWait(loop, [&]()
+               {
+        acceptor = std::make_shared<rs_acceptor::Acceptor>(loop, port);
+        acceptor->setAcceptBatchCallback([&](const std::vector<int> &fds)
+                                         {
+            accepted.insert(accepted.end(), fds.begin(), fds.end());
+            accepted_count = accepted.size(); });
+        acceptor->enableConcerningAcceptFd(); });
+
+    std::vector<int> conns;
+    for (int i = 0; i < clients; i++)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        assert(connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == 0);
+        conns.push_back(fd);
+    }
+    for (int i = 0; i < 1000 && accepted_count < clients; i++)
+        sleepMs(1);
+    assert(accepted_count == clients);
+
+    // 获取到的连接已经设置为非阻塞
+    runAndWait(loop, [&]()
+               {
+        for (int fd : accepted)
+        {
+            assert(fcntl(fd, F_GETFL) & O_NONBLOCK);
+            close(fd);
+        } });
+    for (int fd : conns)
+        close(fd);
+
+    std::cout << "✓ 获取连接请求完成结果测试通过" << std::endl;
+}
+
+int main()
+{
+    std::cout << "开始 io_uring 事件监控测试...\n"
+              << std::endl;
+
+    rs_loop_thread::LoopThread thread(TaskQueueType::Locked, rs_poller::PollerType::IoUring);
+    EventLoopLockQueue *loop = thread.getLoop();
+    if (loop->getPollerType() != rs_poller::PollerType::IoUring)
+        std::cout << "内核不支持io_uring，以下测试使用epoll" << std::endl;
+
+    testWakeupAndTimer(loop);
+    testLevelTriggered(loop);
+    testEdgeTriggered(loop);
+    if (loop->isCompletionEnabled())
+    {
+        testRecvCompletion(loop);
+        testAcceptCompletion(loop);
+    }
+    else
+    {
+        std::cout << "内核不支持多次触发的接收请求，跳过完成结果测试" << std::endl;
+    }
+
+    std::cout << "\n🎉 所有测试通过！" << std::endl;
+
+    // 从属线程中的事件循环不会退出，直接结束进程
+    std::cout.flush();
+    std::_Exit(0);
+}
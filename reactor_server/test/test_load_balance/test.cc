@@ -0,0 +1,202 @@
+#include <reactor_server/net/loop_thread_pool.h>
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <set>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+using namespace rs_loop_thread_pool;
+using rs_event_loop_lock_queue::EventLoopLockQueue;
+
+const int thread_num = 4;
+
+// 在指定事件循环线程中执行任务并等待执行完毕
+void runAndWait(EventLoopLockQueue *loop, const std::function<void()> &task)
+{
+    std::atomic<bool> done(false);
+    loop->runTasks([&]()
+                   {
+        task();
+        done = true; });
+    while (!done)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+void testRoundRobin(LoopThreadPool &pool)
+{
+    std::cout << "测试轮询分配..." << std::endl;
+
+    pool.setLoadBalancePolicy(LoadBalancePolicy::RoundRobin);
+    std::set<EventLoopLockQueue *> picked;
+    for (int i = 0; i < thread_num; i++)
+        picked.insert(pool.getNextLoop());
+    assert(picked.size() == thread_num);
+
+    std::cout << "✓ 轮询分配测试通过" << std::endl;
+}
+
+void testLeastConnections(LoopThreadPool &pool)
+{
+    std::cout << "测试最少连接数分配..." << std::endl;
+
+    pool.setLoadBalancePolicy(LoadBalancePolicy::LeastConnections);
+    std::vector<EventLoopLockQueue *> loops = pool.getAllLoops();
+    // 除最后一个事件循环外都已经分配了连接
+    for (int i = 0; i < thread_num - 1; i++)
+        loops[i]->addConnection();
+    for (int i = 0; i < thread_num; i++)
+        assert(pool.getNextLoop() == loops[thread_num - 1]);
+
+    // 连接数相同时依次分配到不同的事件循环
+    loops[thread_num - 1]->addConnection();
+    std::set<EventLoopLockQueue *> picked;
+    for (int i = 0; i < thread_num; i++)
+        picked.insert(pool.getNextLoop());
+    assert(picked.size() == thread_num);
+
+    for (auto loop : loops)
+        runAndWait(loop, [loop]()
+                   { loop->removeConnection(); });
+    for (auto loop : loops)
+        assert(loop->getActiveConnections() == 0);
+
+    std::cout << "✓ 最少连接数分配测试通过" << std::endl;
+}
+
+void testLeastPendingBytes(LoopThreadPool &pool)
+{
+    std::cout << "测试最少待发送数据量分配..." << std::endl;
+
+    pool.setLoadBalancePolicy(LoadBalancePolicy::LeastPendingBytes);
+    std::vector<EventLoopLockQueue *> loops = pool.getAllLoops();
+    for (int i = 0; i < thread_num; i++)
+        runAndWait(loops[i], [loop = loops[i], i]()
+                   { loop->addPendingBytes(1000 - i * 100); });
+    assert(pool.getNextLoop() == loops[thread_num - 1]);
+
+    for (int i = 0; i < thread_num; i++)
+        runAndWait(loops[i], [loop = loops[i], i]()
+                   { loop->addPendingBytes(-(1000 - i * 100)); });
+
+    std::cout << "✓ 最少待发送数据量分配测试通过" << std::endl;
+}
+
+void testLeastLoopLag(LoopThreadPool &pool)
+{
+    std::cout << "测试最小事件循环延迟分配..." << std::endl;
+
+    pool.setLoadBalancePolicy(LoadBalancePolicy::LeastLoopLag);
+    std::vector<EventLoopLockQueue *> loops = pool.getAllLoops();
+    // 前三个事件循环执行耗时任务，执行期间延迟明显升高
+    std::atomic<int> running(0);
+    std::atomic<bool> release(false);
+    for (int i = 0; i < thread_num - 1; i++)
+        loops[i]->runTasks([&]()
+                           {
+            running++;
+            while (!release)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1)); });
+    while (running < thread_num - 1)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    for (int i = 0; i < thread_num - 1; i++)
+        assert(loops[i]->getLoopLagUs() > loops[thread_num - 1]->getLoopLagUs());
+    assert(pool.getNextLoop() == loops[thread_num - 1]);
+
+    // 耗时任务结束后滑动平均值仍然较高
+    release = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    assert(loops[0]->getLoopLagUs() > 0);
+
+    // 空闲之后延迟随时间衰减，空闲的事件循环重新可以被选中
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    std::set<EventLoopLockQueue *> picked;
+    for (int i = 0; i < thread_num; i++)
+    {
+        assert(loops[i]->getLoopLagUs() < 1000);
+        picked.insert(pool.getNextLoop());
+    }
+    assert(picked.size() == thread_num);
+
+    std::cout << "✓ 最小事件循环延迟分配测试通过" << std::endl;
+}
+
+void testConsistentHash(LoopThreadPool &pool)
+{
+    std::cout << "测试一致性哈希分配..." << std::endl;
+
+    // 监听本地随机端口
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    assert(bind(listen_fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == 0);
+    assert(listen(listen_fd, 16) == 0);
+    socklen_t len = sizeof(addr);
+    getsockname(listen_fd, reinterpret_cast<struct sockaddr *>(&addr), &len);
+
+    // 同一地址的多个连接（端口不同）分配到同一事件循环
+    std::set<EventLoopLockQueue *> picked;
+    std::vector<int> fds;
+    for (int i = 0; i < 8; i++)
+    {
+        int client = socket(AF_INET, SOCK_STREAM, 0);
+        assert(connect(client, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == 0);
+        int server = accept(listen_fd, nullptr, nullptr);
+        assert(server >= 0);
+        picked.insert(pool.getNextLoop(server));
+        fds.push_back(client);
+        fds.push_back(server);
+    }
+    assert(picked.size() == 1);
+
+    // 无法获取对端地址时退化为轮询
+    picked.clear();
+    for (int i = 0; i < thread_num; i++)
+        picked.insert(pool.getNextLoop());
+    assert(picked.size() == thread_num);
+
+    for (int fd : fds)
+        close(fd);
+    close(listen_fd);
+
+    std::cout << "✓ 一致性哈希分配测试通过" << std::endl;
+}
+
+int main()
+{
+    std::cout << "开始负载均衡策略测试...\n"
+              << std::endl;
+
+    EventLoopLockQueue base_loop;
+    LoopThreadPool pool(&base_loop);
+    pool.setThreadNum(thread_num);
+    pool.createLoopThread();
+
+    testRoundRobin(pool);
+    testLeastConnections(pool);
+    testLeastPendingBytes(pool);
+    testLeastLoopLag(pool);
+
+    // 一致性哈希环在创建从属线程时构建
+    LoopThreadPool hash_pool(&base_loop);
+    hash_pool.setThreadNum(thread_num);
+    hash_pool.setLoadBalancePolicy(LoadBalancePolicy::ConsistentHash);
+    hash_pool.createLoopThread();
+    testConsistentHash(hash_pool);
+
+    // 创建从属线程之后再设置策略时立即构建哈希环
+    pool.setLoadBalancePolicy(LoadBalancePolicy::ConsistentHash);
+    testConsistentHash(pool);
+
+    std::cout << "\n🎉 所有测试通过！" << std::endl;
+
+    // 从属线程中的事件循环不会退出，直接结束进程
+    std::cout.flush();
+    std::_Exit(0);
+}
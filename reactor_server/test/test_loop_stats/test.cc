@@ -0,0 +1,97 @@
+#include <reactor_server/net/loop_thread.h>
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+using namespace rs_loop_stats;
+using namespace rs_event_loop_lock_queue;
+
+void testHistogram()
+{
+    std::cout << "测试直方图..." << std::endl;
+
+    // 每个值都落在上界不小于该值的区间内，且相对误差不超过12.5%
+    for (uint64_t value : {0ull, 1ull, 7ull, 8ull, 9ull, 15ull, 16ull, 100ull, 1000ull, 123456ull, 4294967295ull})
+    {
+        size_t index = Histogram::getIndex(value);
+        assert(index < histogram_buckets);
+        uint64_t upper = Histogram::getUpperBound(index);
+        assert(upper >= value);
+        assert(upper - value <= value / 8);
+    }
+    // 区间下标单调
+    for (uint64_t value = 1; value < 100000; value++)
+        assert(Histogram::getIndex(value) >= Histogram::getIndex(value - 1));
+
+    Histogram histogram;
+    for (uint64_t value = 1; value <= 1000; value++)
+        histogram.record(value);
+    HistogramSnapshot snap = histogram.snapshot();
+    assert(snap.count == 1000);
+    assert(snap.max == 1000);
+    assert(snap.getMean() == 500.5);
+    uint64_t p50 = snap.getPercentile(50);
+    assert(p50 >= 500 && p50 <= 500 + 500 / 8);
+    uint64_t p99 = snap.getPercentile(99);
+    assert(p99 >= 990 && p99 <= 1000);
+    assert(snap.getPercentile(100) == 1000);
+
+    // 超过上限的值按上限记录
+    histogram.record(UINT64_MAX);
+    assert(histogram.snapshot().max == histogram_max_value);
+
+    std::cout << "✓ 直方图测试通过" << std::endl;
+}
+
+void testLoopStats()
+{
+    std::cout << "测试事件循环统计..." << std::endl;
+
+    auto thread = new rs_loop_thread::LoopThread();
+    EventLoopLockQueue *loop = thread->getLoop();
+
+    // 每次投递一批任务，任务执行期间耗时1毫秒
+    std::atomic<int> done(0);
+    for (int i = 0; i < 10; i++)
+    {
+        for (int j = 0; j < 5; j++)
+            loop->runTasks([&]()
+                           { done++; });
+        loop->runTasks([&]()
+                       {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            done++; });
+        while (done < (i + 1) * 6)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    LoopStatsSnapshot snap = loop->getLoopStats();
+    assert(snap.iterations >= 10);
+    assert(snap.tasks_per_drain.count >= 10);
+    assert(snap.tasks_per_drain.sum >= 60);
+    assert(snap.task_delay_us.count == snap.tasks_per_drain.count);
+    assert(snap.ready_events.count == snap.iterations);
+    assert(snap.task_us >= 10 * 1000);
+    assert(snap.iteration_us.max >= 1000);
+    assert(snap.wait_us > 0);
+
+    std::cout << "✓ 事件循环统计测试通过" << std::endl;
+}
+
+int main()
+{
+    std::cout << "开始事件循环统计测试...\n"
+              << std::endl;
+
+    testHistogram();
+    testLoopStats();
+
+    std::cout << "\n🎉 所有测试通过！" << std::endl;
+
+    // 从属线程中的事件循环不会退出，直接结束进程
+    std::cout.flush();
+    std::_Exit(0);
+}
@@ -4,7 +4,6 @@
 #include <unistd.h>
 #include <algorithm>
 #include <reactor_server/base/log.h>
-#include <reactor_server/base/uuid_generator.h>
 #include <reactor_server/net/socket.h>
 #include <reactor_server/net/channel.h>
 #include <reactor_server/net/connection.h>
@@ -14,7 +13,9 @@
 using namespace rs_log_system;
 
 // 管理所有客户端连接的哈希表
-std::unordered_map<std::string, rs_connection::Connection::ptr> clients;
+std::unordered_map<uint64_t, rs_connection::Connection::ptr> clients;
+// 下一个连接ID
+uint64_t next_id = 0;
 // 创建两个从属线程进行连接事件处理
 std::vector<rs_loop_thread::LoopThread> sub_threads(2);
 // 线程选择下标
@@ -30,7 +31,7 @@ void handleAccept(int fd)
 
     next_thread = (next_thread + 1) % 2;
     // 创建客户端套接字结构
-    const std::string id = rs_uuid_generator::UuidGenerator::generate_uuid();
+    uint64_t id = ++next_id;
     rs_event_loop_lock_queue::EventLoopLockQueue::ptr loop(sub_threads[next_thread].getLoop());
     rs_connection::Connection::ptr client = std::make_shared<rs_connection::Connection>(loop, id, fd);
 
@@ -4,7 +4,6 @@
 #include <unistd.h>
 #include <algorithm>
 #include <reactor_server/base/log.h>
-#include <reactor_server/base/uuid_generator.h>
 #include <reactor_server/net/socket.h>
 #include <reactor_server/net/channel.h>
 #include <reactor_server/net/connection.h>
@@ -14,7 +13,9 @@
 using namespace rs_log_system;
 
 // 管理所有客户端连接的哈希表
-std::unordered_map<std::string, rs_connection::Connection::ptr> clients;
+std::unordered_map<uint64_t, rs_connection::Connection::ptr> clients;
+// 下一个连接ID
+uint64_t next_id = 0;
 // 从属线程管理
 rs_loop_thread_pool::LoopThreadPool::ptr loops;
 
@@ -28,7 +29,7 @@ void handleAccept(int fd)
     std::cout << "当前线程为：" << pthread_self() << std::endl;
 
     // 创建客户端套接字结构
-    const std::string id = rs_uuid_generator::UuidGenerator::generate_uuid();
+    uint64_t id = ++next_id;
     rs_connection::Connection::ptr client = std::make_shared<rs_connection::Connection>(loops->getNextLoop(), id, fd);
 
     client->enableTimeoutRelease(10);
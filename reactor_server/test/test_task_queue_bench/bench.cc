@@ -0,0 +1,60 @@
+/* 任务队列入队吞吐测试：1~16个生产者线程同时向同一个事件循环投递任务，比较互斥锁队列与无锁队列 */
+// 操作：./bench [每个生产者投递的任务数]
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <reactor_server/net/loop_thread.h>
+
+using namespace rs_event_loop_lock_queue;
+
+// 返回每秒入队任务数
+double runBench(EventLoopLockQueue *loop, int producers, size_t tasks_per_producer)
+{
+    std::atomic<size_t> executed(0);
+    size_t total = producers * tasks_per_producer;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < producers; i++)
+    {
+        threads.emplace_back([&]()
+                             {
+            for (size_t j = 0; j < tasks_per_producer; j++)
+                loop->enqueue([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); }); });
+    }
+    for (auto &t : threads)
+        t.join();
+    auto enqueued = std::chrono::steady_clock::now();
+
+    // 等待事件循环执行完所有任务
+    while (executed.load(std::memory_order_relaxed) < total)
+        std::this_thread::yield();
+
+    double seconds = std::chrono::duration<double>(enqueued - start).count();
+    return total / seconds;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t tasks_per_producer = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+    // 事件循环线程常驻，测试结束时随进程退出
+    auto locked = new rs_loop_thread::LoopThread(TaskQueueType::Locked);
+    auto lock_free = new rs_loop_thread::LoopThread(TaskQueueType::LockFree);
+
+    std::printf("%-10s %16s %16s\n", "producers", "locked(ops/s)", "lock-free(ops/s)");
+    for (int producers : {1, 2, 4, 8, 16})
+    {
+        double locked_ops = runBench(locked->getLoop(), producers, tasks_per_producer);
+        double lock_free_ops = runBench(lock_free->getLoop(), producers, tasks_per_producer);
+        std::printf("%-10d %16.0f %16.0f\n", producers, locked_ops, lock_free_ops);
+    }
+
+    std::fflush(stdout);
+    std::_Exit(0);
+}
@@ -4,7 +4,6 @@
 #include <unistd.h>
 #include <algorithm>
 #include <reactor_server/base/log.h>
-#include <reactor_server/base/uuid_generator.h>
 #include <reactor_server/net/socket.h>
 #include <reactor_server/net/channel.h>
 #include <reactor_server/net/event_loop_lock_queue.h>
@@ -14,7 +13,7 @@ using namespace rs_log_system;
 void handleRead(const rs_channel::Channel::ptr &client_channel, const rs_socket::Socket::ptr &client_socket);
 void handleWrite(const rs_channel::Channel::ptr &client_channel, const rs_socket::Socket::ptr &client_socket);
 void handleClose(const rs_channel::Channel::ptr &client_channel, const rs_socket::Socket::ptr &client_socket);
-void handleAny(const rs_channel::Channel::ptr &channel, rs_event_loop_lock_queue::EventLoopLockQueue *loop, const std::string &id);
+void handleAny(const rs_channel::Channel::ptr &channel, rs_event_loop_lock_queue::EventLoopLockQueue *loop, rs_timing_wheel::TimerId id);
 
 void handleAccept(const rs_channel::Channel::ptr &channel, const rs_socket::Socket::ptr &socket, rs_event_loop_lock_queue::EventLoopLockQueue *loop)
 {
@@ -27,14 +26,12 @@ void handleAccept(const rs_channel::Channel::ptr &channel, const rs_socket::Sock
     client_channel->setWriteCallback(std::bind(&handleWrite, client_channel, client_socket));
     client_channel->setCloseCallback(std::bind(&handleClose, client_channel, client_socket));
 
-    const std::string id = rs_uuid_generator::UuidGenerator::generate_uuid();
-
-    // 设置任意事件为刷新定时任务超时时间
-    client_channel->setAnyCallback(std::bind(handleAny, client_channel, loop, id));
     // 创建定时任务
     // 10s为一个连接的超时时间，一旦超时，说明该连接不活跃，移除该连接
     // 需要注意，设置超时任务一定要在读事件监控开启之前，防止出现任务开始计时之前就已经有了读事件触发导致任务没有被及时刷新
-    loop->insertTask(id, 10, std::bind(handleClose, client_channel, client_socket));
+    rs_timing_wheel::TimerId id = loop->insertTask(10u, std::bind(handleClose, client_channel, client_socket));
+    // 设置任意事件为刷新定时任务超时时间
+    client_channel->setAnyCallback(std::bind(handleAny, client_channel, loop, id));
     // 对客户端数据文件描述符启用读事件监控
     client_channel->enableConcerningReadFd();
 }
@@ -84,7 +81,7 @@ void handleClose(const rs_channel::Channel::ptr &client_channel, const rs_socket
     client_socket->close();    
 }
 
-void handleAny(const rs_channel::Channel::ptr &channel, rs_event_loop_lock_queue::EventLoopLockQueue *loop, const std::string &id)
+void handleAny(const rs_channel::Channel::ptr &channel, rs_event_loop_lock_queue::EventLoopLockQueue *loop, rs_timing_wheel::TimerId id)
 {
     loop->refreshTask(id);
 }
@@ -0,0 +1,160 @@
+#include <reactor_server/net/event_loop_lock_queue.h>
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+
+using namespace rs_event_loop_lock_queue;
+using namespace std::chrono;
+
+steady_clock::time_point start;
+std::vector<std::pair<std::string, long>> fired; // 任务编号与实际触发时间（毫秒）
+
+long elapsed()
+{
+    return duration_cast<milliseconds>(steady_clock::now() - start).count();
+}
+
+void record(const std::string &id)
+{
+    fired.emplace_back(id, elapsed());
+}
+
+// 检查任务是否在预期时间之后的容忍范围内触发
+void checkFired(const std::string &id, long expect)
+{
+    for (auto &p : fired)
+    {
+        if (p.first != id)
+            continue;
+        std::cout << "任务" << id << "预期" << expect << "ms，实际" << p.second << "ms" << std::endl;
+        assert(p.second >= expect);
+        // 上限只用于发现明显的延迟，留出足够余量避免机器繁忙时误报
+        assert(p.second < expect + 300);
+        return;
+    }
+    assert(false);
+}
+
+int countFired(const std::string &id)
+{
+    int count = 0;
+    for (auto &p : fired)
+        if (p.first == id)
+            count++;
+    return count;
+}
+
+bool isFired(const std::string &id)
+{
+    for (auto &p : fired)
+        if (p.first == id)
+            return true;
+    return false;
+}
+
+// 只有秒级超时任务的事件循环，不应该按照第0层一圈的时长频繁唤醒
+std::atomic<EventLoopLockQueue *> idle_loop{nullptr};
+
+void runIdleLoop()
+{
+    EventLoopLockQueue loop;
+    // 默认的HTTP空闲超时时间，任务位于第1层
+    loop.insertTask(10u, []() {});
+    loop.insertTask(20u, []() {});
+    // 短超时任务执行后根据剩余任务重新设置定时器
+    loop.insertTask(milliseconds(50), []() {});
+    idle_loop.store(&loop);
+    loop.startEventLoop();
+}
+
+int main()
+{
+    std::cout << "开始分层时间轮功能测试...\n"
+              << std::endl;
+
+    std::thread idle_thread(runIdleLoop);
+    idle_thread.detach();
+
+    EventLoopLockQueue loop;
+    start = steady_clock::now();
+
+    // 毫秒级超时，跨越第0层边界以及落在第1层的任务
+    auto a = loop.insertTask(milliseconds(30), std::bind(record, "a"));
+    loop.insertTask(milliseconds(100), std::bind(record, "b"));
+    loop.insertTask(milliseconds(300), std::bind(record, "c"));
+    loop.insertTask(milliseconds(1200), std::bind(record, "d"));
+    // 以秒为单位的接口
+    loop.insertTask(1u, std::bind(record, "g"));
+
+    // 取消的任务不会执行
+    auto e = loop.insertTask(milliseconds(50), std::bind(record, "e"));
+    loop.cancelTask(e);
+    assert(!loop.hasTimer(e));
+
+    // 取消后节点被复用，旧句柄不会影响新任务
+    auto f = loop.insertTask(milliseconds(200), std::bind(record, "f"));
+    assert(f.index == e.index && f.generation != e.generation);
+    loop.cancelTask(e);
+    assert(loop.hasTimer(f));
+
+    // 刷新后的任务从刷新时刻重新计时
+    loop.insertTask(milliseconds(150), [&loop, f]()
+                    { loop.refreshTask(f); });
+
+    // 超过60秒以及超过最大跨度的任务可以正常放入时间轮
+    auto h = loop.insertTask(minutes(10), std::bind(record, "h"));
+    auto i = loop.insertTask(hours(24 * 100), std::bind(record, "i"));
+    assert(loop.hasTimer(h) && loop.hasTimer(i));
+
+    // 大量任务跨越任务节点数组的多个分块，取消中间的任务后复用的节点不能与存活的任务冲突
+    std::vector<rs_timing_wheel::TimerId> many;
+    for (int k = 0; k < 200; k++)
+        many.push_back(loop.insertTask(milliseconds(400), std::bind(record, "m" + std::to_string(k))));
+    for (int k = 20; k < 180; k += 2)
+        loop.cancelTask(many[k]);
+    std::vector<rs_timing_wheel::TimerId> reused;
+    for (int k = 0; k < 100; k++)
+        reused.push_back(loop.insertTask(milliseconds(500), std::bind(record, "r" + std::to_string(k))));
+    for (int k = 0; k < 200; k++)
+        assert(loop.hasTimer(many[k]) == (k < 20 || k >= 180 || k % 2 == 1));
+    for (auto &id : reused)
+        assert(loop.hasTimer(id));
+
+    loop.insertTask(milliseconds(1500), [&loop, a, h, i]()
+                    {
+        // 空闲的事件循环除了执行短超时任务之外，1.5秒内不需要为了降级而唤醒
+        EventLoopLockQueue *idle = idle_loop.load();
+        assert(idle != nullptr);
+        uint64_t iterations = idle->getLoopStats().iterations;
+        std::cout << "空闲事件循环唤醒" << iterations << "次" << std::endl;
+        assert(iterations <= 2);
+        for (int k = 0; k < 200; k++)
+            assert(countFired("m" + std::to_string(k)) == ((k < 20 || k >= 180 || k % 2 == 1) ? 1 : 0));
+        for (int k = 0; k < 100; k++)
+            assert(countFired("r" + std::to_string(k)) == 1);
+        checkFired("a", 30);
+        checkFired("b", 100);
+        checkFired("c", 300);
+        checkFired("f", 350);
+        checkFired("g", 1000);
+        checkFired("d", 1200);
+        assert(!isFired("e"));
+        assert(!isFired("h") && !isFired("i"));
+        // 已经执行的任务句柄失效
+        assert(!loop.hasTimer(a));
+        assert(loop.hasTimer(h) && loop.hasTimer(i));
+        loop.cancelTask(h);
+        loop.cancelTask(i);
+        assert(!loop.hasTimer(h) && !loop.hasTimer(i));
+
+        std::cout << "\n🎉 所有测试通过！" << std::endl;
+        std::_Exit(0); });
+
+    loop.startEventLoop();
+
+    return 0;
+}